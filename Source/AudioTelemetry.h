@@ -0,0 +1,187 @@
+#pragma once
+
+#include "LockFreeFifo.h"
+#include "WaveformPyramid.h"
+
+// One entry per processed block, written by the audio thread and drained by the editor
+struct TelemetryFrame
+{
+    static constexpr int maxChannels = 64; // Enough for 7th-order ambisonics; meters beyond this are dropped
+
+    int numChannels = 0;
+    float peaks[maxChannels];       // Block peak of each channel, only the first numChannels are valid
+    float meanSquares[maxChannels]; // Block mean square of each channel, for the RMS ballistics
+};
+
+// Audio-to-GUI channel owned by the processor. The editor switches it on while
+// it is open; when it's off the audio thread doesn't measure or push anything.
+// The queues (most of a megabyte) are only allocated the first time an editor or the
+// spectrum view switches them on, so instances that are never looked at don't carry them.
+class AudioTelemetry
+{
+public:
+    AudioTelemetry() = default;
+
+    void setEnabled(bool shouldBeEnabled) // Message thread
+    {
+        if (shouldBeEnabled)
+        {
+            allocateQueues();
+
+            // Don't show whatever was left from the last time the editor was open
+            queues->frames.discardAll();
+            queues->waveform.discardAll();
+        }
+
+        enabled.store(shouldBeEnabled, std::memory_order_release);
+    }
+
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_acquire); }
+
+    void setSampleRate(double newSampleRate) noexcept { sampleRate.store(newSampleRate); }
+    double getSampleRate() const noexcept { return sampleRate.load(); }
+
+    //==============================================================================
+    // Audio thread, only while isEnabled() (the queues exist from then on)
+    void push(const TelemetryFrame& frame) noexcept { queues->frames.push(frame); }
+
+    // Decimates a whole block into min/max buckets of WaveformPyramid::baseBucketSize samples.
+    // Bucket boundaries carry across blocks, so the result doesn't depend on the host buffer size.
+    void pushWaveform(const float* left, const float* right, int numSamples) noexcept
+    {
+        if (! waveformActive)
+        {
+            pendingCount = 0; // Telemetry was just switched on, start a fresh bucket
+            waveformActive = true;
+        }
+
+        for (int i = 0; i < numSamples;)
+        {
+            const int count = std::min(numSamples - i, WaveformPyramid::baseBucketSize - pendingCount);
+            const auto leftRange = juce::FloatVectorOperations::findMinAndMax(left + i, count);
+            const auto rightRange = juce::FloatVectorOperations::findMinAndMax(right + i, count);
+
+            if (pendingCount == 0)
+            {
+                pendingBucket.minimum[0] = leftRange.getStart();
+                pendingBucket.maximum[0] = leftRange.getEnd();
+                pendingBucket.minimum[1] = rightRange.getStart();
+                pendingBucket.maximum[1] = rightRange.getEnd();
+            }
+            else
+            {
+                pendingBucket.minimum[0] = std::min(pendingBucket.minimum[0], leftRange.getStart());
+                pendingBucket.maximum[0] = std::max(pendingBucket.maximum[0], leftRange.getEnd());
+                pendingBucket.minimum[1] = std::min(pendingBucket.minimum[1], rightRange.getStart());
+                pendingBucket.maximum[1] = std::max(pendingBucket.maximum[1], rightRange.getEnd());
+            }
+
+            pendingCount += count;
+            i += count;
+
+            if (pendingCount == WaveformPyramid::baseBucketSize)
+            {
+                queues->waveform.push(pendingBucket);
+                pendingCount = 0;
+            }
+        }
+    }
+
+    // Called instead of the above while the editor is closed
+    void waveformIdle() noexcept { waveformActive = false; }
+
+    // Mono mix of the block for the spectrum analyzer, only while it is running. A block that doesn't
+    // fit in its queue is dropped whole and counted, so the analyzer never sees half of one.
+    void pushSpectrum(const float* left, const float* right, int numSamples) noexcept
+    {
+        if (! spectrumEnabled.load(std::memory_order_acquire))
+            return;
+
+        auto& spectrumFifo = queues->spectrumFifo;
+
+        if (spectrumFifo.getFreeSpace() < numSamples)
+        {
+            spectrumOverruns.fetch_add(1, std::memory_order_release);
+            return;
+        }
+
+        const auto scope = spectrumFifo.write(numSamples);
+
+        auto mix = [&](int destStart, int sourceStart, int count)
+            {
+                for (int i = 0; i < count; ++i)
+                    queues->spectrumSamples[(size_t)(destStart + i)] = 0.5f * (left[sourceStart + i] + right[sourceStart + i]);
+            };
+
+        mix(scope.startIndex1, 0, scope.blockSize1);
+        mix(scope.startIndex2, scope.blockSize1, scope.blockSize2);
+    }
+
+    //==============================================================================
+    // Message thread
+    bool pop(TelemetryFrame& frame) noexcept { return queues != nullptr && queues->frames.pop(frame); }
+    bool popWaveform(WaveformBucket& bucket) noexcept { return queues != nullptr && queues->waveform.pop(bucket); }
+
+    //==============================================================================
+    // Spectrum analyzer (see SpectrumAnalyzer.h), the only reader of the spectrum queue. It's
+    // switched on from the message thread before the worker starts reading.
+    void setSpectrumEnabled(bool shouldBeEnabled)
+    {
+        if (shouldBeEnabled)
+        {
+            allocateQueues();
+            discardSpectrum(); // Nothing stale from the last run
+        }
+
+        spectrumEnabled.store(shouldBeEnabled, std::memory_order_release);
+    }
+
+    // Blocks dropped so far because the queue was full; the stream has a gap after each one
+    int getSpectrumOverruns() const noexcept { return spectrumOverruns.load(std::memory_order_acquire); }
+
+    // Throws away everything queued, e.g. to restart cleanly after an overrun
+    void discardSpectrum() noexcept { queues->spectrumFifo.read(queues->spectrumFifo.getNumReady()); }
+
+    // Copies up to maxSamples queued samples into dest, returns how many
+    int popSpectrum(float* dest, int maxSamples) noexcept
+    {
+        const auto scope = queues->spectrumFifo.read(maxSamples);
+        std::copy_n(queues->spectrumSamples.data() + scope.startIndex1, scope.blockSize1, dest);
+        std::copy_n(queues->spectrumSamples.data() + scope.startIndex2, scope.blockSize2, dest + scope.blockSize1);
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+private:
+    static constexpr int spectrumCapacity = 32768; // ~170 ms at 192 kHz
+
+    struct Queues
+    {
+        LockFreeFifo<TelemetryFrame> frames{ 1024 };   // ~170 ms of 32-sample blocks at 192 kHz
+        LockFreeFifo<WaveformBucket> waveform{ 8192 }; // ~340 ms of buckets at 192 kHz
+        juce::AbstractFifo spectrumFifo{ spectrumCapacity };
+        std::vector<float> spectrumSamples = std::vector<float>((size_t)spectrumCapacity);
+    };
+
+    // Message thread, before either flag is set, so the audio thread sees the queues once it sees
+    // the flag. They stay until the processor goes, so nothing can be freed under the audio thread.
+    void allocateQueues()
+    {
+        if (queues == nullptr)
+            queues = std::make_unique<Queues>();
+    }
+
+    std::atomic<bool> enabled{ false };
+    std::atomic<double> sampleRate{ 44100.0 };
+
+    std::unique_ptr<Queues> queues;
+
+    std::atomic<bool> spectrumEnabled{ false };
+    std::atomic<int> spectrumOverruns{ 0 };
+
+    // Audio thread only
+    WaveformBucket pendingBucket;
+    int pendingCount = 0;
+    bool waveformActive = false;
+
+    JUCE_DECLARE_NON_COPYABLE(AudioTelemetry)
+};
@@ -0,0 +1,104 @@
+#include "AutoGain.h"
+#include "SimdFloat.h"
+
+void AutoGain::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    makeup.reset(sampleRate, rampSeconds);
+    reset();
+}
+
+void AutoGain::reset()
+{
+    blockInputMeanSquare = 0.0f;
+    inputPower = 0.0;
+    outputPower = 0.0;
+    makeup.setCurrentAndTargetValue(1.0f);
+}
+
+void AutoGain::setEnabled(bool shouldBeEnabled) noexcept
+{
+    if (shouldBeEnabled == enabled)
+        return;
+
+    enabled = shouldBeEnabled;
+
+    // Start tracking from scratch next time, and head back to unity now
+    inputPower = 0.0;
+    outputPower = 0.0;
+    makeup.setTargetValue(1.0f);
+}
+
+float AutoGain::getMeanSquare(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int numSamples = (int)block.getNumSamples();
+    const int numChannels = (int)block.getNumChannels();
+
+    if (numSamples == 0 || numChannels == 0)
+        return 0.0f;
+
+    double sum = 0.0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* data = block.getChannelPointer((size_t)channel);
+        auto squares = SimdFloat::broadcast(0.0f);
+        int i = 0;
+
+        for (; i + SimdFloat::size <= numSamples; i += SimdFloat::size)
+        {
+            const auto x = SimdFloat::load(data + i);
+            squares = squares + x * x;
+        }
+
+        alignas(64) float lanes[SimdFloat::size];
+        squares.store(lanes);
+
+        float channelSum = 0.0f;
+        for (auto lane : lanes)
+            channelSum += lane;
+
+        for (; i < numSamples; ++i)
+            channelSum += data[i] * data[i];
+
+        sum += channelSum;
+    }
+
+    return (float)(sum / ((double)numSamples * numChannels));
+}
+
+void AutoGain::measureInput(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    blockInputMeanSquare = enabled ? getMeanSquare(block) : 0.0f;
+}
+
+void AutoGain::process(juce::dsp::AudioBlock<float> block) noexcept
+{
+    if (enabled)
+    {
+        const int numSamples = (int)block.getNumSamples();
+
+        // While the input is silent, keep the last makeup instead of chasing the noise floor
+        if (blockInputMeanSquare > silenceMeanSquare)
+        {
+            const double blockOutputMeanSquare = getMeanSquare(block);
+
+            // One-pole averages weighted by block length, so the time constant doesn't depend on the buffer size
+            const double coefficient = std::exp(-numSamples / (sampleRate * timeConstantSeconds));
+            inputPower = coefficient * inputPower + (1.0 - coefficient) * blockInputMeanSquare;
+            outputPower = coefficient * outputPower + (1.0 - coefficient) * blockOutputMeanSquare;
+
+            if (outputPower > 0.0)
+            {
+                const float maximumGain = juce::Decibels::decibelsToGain(maximumDecibels);
+                makeup.setTargetValue(juce::jlimit(1.0f / maximumGain, maximumGain, (float)std::sqrt(inputPower / outputPower)));
+            }
+        }
+    }
+
+    // Settled at unity (the usual case with auto gain off) costs nothing
+    if (! isActive())
+        return;
+
+    block.multiplyBy(makeup);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Optional makeup gain that keeps the output as loud as the input, so turning the drive up
+// changes the tone rather than the level. Input and output power are tracked with one-pole
+// running averages of each block's mean square: a single pass over the block and O(1) state,
+// no lookahead and no history. The makeup gain ramps towards sqrt(input / output).
+class AutoGain
+{
+public:
+    static constexpr double timeConstantSeconds = 0.4; // Loudness averaging, roughly a momentary LUFS window
+    static constexpr double rampSeconds = 0.1;         // Makeup gain smoothing
+    static constexpr float maximumDecibels = 24.0f;    // Makeup is clamped to +/- this
+    static constexpr float silenceMeanSquare = 1.0e-7f; // -70 dBFS; quieter input holds the current makeup
+
+    AutoGain() = default;
+
+    void prepare(double sampleRate);
+    void reset(); // Back to unity gain and no history
+
+    void setEnabled(bool shouldBeEnabled) noexcept; // Disabling ramps back to unity
+
+    // Before any processing: takes the block's input power
+    void measureInput(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    // After processing: takes the output power, updates the makeup and applies it to the block
+    void process(juce::dsp::AudioBlock<float> block) noexcept;
+
+    float getCurrentGain() const noexcept { return makeup.getCurrentValue(); }
+    bool isActive() const noexcept { return enabled || makeup.isSmoothing() || makeup.getTargetValue() != 1.0f; }
+
+    static float getMeanSquare(const juce::dsp::AudioBlock<float>& block) noexcept; // Across all channels, vectorised
+
+private:
+    double sampleRate = 44100.0;
+    bool enabled = false;
+
+    float blockInputMeanSquare = 0.0f;
+    double inputPower = 0.0;  // Running averages
+    double outputPower = 0.0;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> makeup{ 1.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutoGain)
+};
@@ -1 +1,94 @@
 #include "CustomLookAndFeel.h"
+
+void CustomLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
+                                         float sliderPos, const float rotaryStartAngle, const float rotaryEndAngle,
+                                         juce::Slider& slider)
+{
+    // Adjust knob position
+    int offsetY = 10; // Move knobs up by reducing the offset
+    y += offsetY;
+
+    // Base dimensions and center
+    auto radius = juce::jmin(width / 2.0f, height / 2.0f) - 10.0f; // Adjust radius for spacing
+    auto centerX = x + width * 0.5f;
+    auto centerY = y + height * 0.5f;
+
+    if (radius <= 0.0f)
+        return;
+
+    // Pick the frame nearest to the slider position
+    const int frameIndex = juce::jlimit(0, KnobFilmstripCache::numFrames - 1,
+                                        juce::roundToInt(sliderPos * (KnobFilmstripCache::numFrames - 1)));
+    const float framePos = (float)frameIndex / (KnobFilmstripCache::numFrames - 1);
+    const bool isHovered = slider.isMouseOverOrDragging();
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    const KnobFilmstripCache::Key key{ juce::roundToInt(radius * 4.0f), juce::roundToInt(scale * 100.0f),
+                                       isHovered, rotaryStartAngle, rotaryEndAngle };
+
+    auto& filmstrips = knobCache->filmstrips;
+    if (filmstrips.size() >= (size_t)KnobFilmstripCache::maxFilmstrips && filmstrips.find(key) == filmstrips.end())
+        filmstrips.clear();
+
+    auto& frame = filmstrips[key].frames[(size_t)frameIndex];
+
+    // Everything is drawn inside the hover glow, which reaches 8 px past the radius
+    const float halfSize = radius + 9.0f;
+
+    if (frame.isNull())
+    {
+        const int imageSize = juce::jmax(1, juce::roundToInt(2.0f * halfSize * scale));
+        frame = juce::Image(juce::Image::ARGB, imageSize, imageSize, true);
+
+        juce::Graphics frameGraphics(frame);
+        frameGraphics.addTransform(juce::AffineTransform::scale((float)imageSize / (2.0f * halfSize)));
+
+        auto angle = rotaryStartAngle + framePos * (rotaryEndAngle - rotaryStartAngle);
+        drawKnob(frameGraphics, halfSize, halfSize, radius, framePos, angle, isHovered);
+    }
+
+    g.drawImage(frame, { centerX - halfSize, centerY - halfSize, 2.0f * halfSize, 2.0f * halfSize });
+}
+
+void CustomLookAndFeel::drawKnob(juce::Graphics& g, float centerX, float centerY, float radius,
+                                 float sliderPos, float angle, bool isHovered)
+{
+    auto rx = centerX - radius;
+    auto ry = centerY - radius;
+    auto rw = radius * 2.0f;
+
+    // --- Outer Shadow for Depth ---
+    g.setColour(juce::Colours::black.withAlpha(0.3f)); // Soft shadow
+    g.fillEllipse(rx - 4, ry - 4, rw + 8, rw + 8);
+
+    // --- Metallic Gradient for the Knob Base ---
+    juce::ColourGradient metallicGradient(juce::Colours::lightgrey, centerX, centerY - radius, // Light at the top
+                                          juce::Colours::darkgrey, centerX, centerY + radius,  // Dark at the bottom
+                                          false);
+    metallicGradient.addColour(0.3, juce::Colours::silver); // Add a brighter metallic shine
+    g.setGradientFill(metallicGradient);
+    g.fillEllipse(rx, ry, rw, rw); // Base fill
+
+    // --- Border for the Knob ---
+    g.setColour(juce::Colours::black.withAlpha(0.8f)); // Dark border
+    g.drawEllipse(rx, ry, rw, rw, 1.5f);
+
+    // --- 3D Highlight for the Knob ---
+    g.setColour(juce::Colours::white.withAlpha(0.2f)); // Subtle highlight
+    g.fillEllipse(rx + 5, ry + 5, rw - 10, rw * 0.5f); // Smaller ellipse on the top half
+
+    // --- White Pointer Line ---
+    juce::Path pointerPath;
+    auto pointerLength = radius * 0.7f;  // Pointer length
+    auto pointerThickness = 2.0f;       // Pointer thickness
+    pointerPath.addRectangle(-pointerThickness * 0.5f, -radius, pointerThickness, pointerLength);
+    pointerPath.applyTransform(juce::AffineTransform::rotation(angle).translated(centerX, centerY));
+    g.setColour(juce::Colours::white);
+    g.fillPath(pointerPath);
+
+    if (isHovered)
+    {
+        g.setColour(juce::Colours::white.withAlpha(0.1f + sliderPos * 0.1f)); // Glow intensity
+        g.fillEllipse(rx - 8, ry - 8, rw + 16, rw + 16); // Glow extends slightly beyond the knob
+    }
+}
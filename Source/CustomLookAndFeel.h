@@ -1,63 +1,16 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <map>
+#include <tuple>
 
 class CustomLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
-    // Override the rotary slider drawing
+    // Override the rotary slider drawing: blits a pre-rendered frame from the filmstrip cache
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                           float sliderPos, const float rotaryStartAngle, const float rotaryEndAngle,
-                          juce::Slider& slider) override
-    {
-        // Adjust knob position
-        int offsetY = 10; // Move knobs up by reducing the offset
-        y += offsetY;
-
-        // Base dimensions and center
-        auto radius = juce::jmin(width / 2.0f, height / 2.0f) - 10.0f; // Adjust radius for spacing
-        auto centerX = x + width * 0.5f;
-        auto centerY = y + height * 0.5f;
-        auto rx = centerX - radius;
-        auto ry = centerY - radius;
-        auto rw = radius * 2.0f;
-        auto angle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
-
-        // --- Outer Shadow for Depth ---
-        g.setColour(juce::Colours::black.withAlpha(0.3f)); // Soft shadow
-        g.fillEllipse(rx - 4, ry - 4, rw + 8, rw + 8);
-
-        // --- Metallic Gradient for the Knob Base ---
-        juce::ColourGradient metallicGradient(juce::Colours::lightgrey, centerX, centerY - radius, // Light at the top
-                                              juce::Colours::darkgrey, centerX, centerY + radius,  // Dark at the bottom
-                                              false);
-        metallicGradient.addColour(0.3, juce::Colours::silver); // Add a brighter metallic shine
-        g.setGradientFill(metallicGradient);
-        g.fillEllipse(rx, ry, rw, rw); // Base fill
-
-        // --- Border for the Knob ---
-        g.setColour(juce::Colours::black.withAlpha(0.8f)); // Dark border
-        g.drawEllipse(rx, ry, rw, rw, 1.5f);
-
-        // --- 3D Highlight for the Knob ---
-        g.setColour(juce::Colours::white.withAlpha(0.2f)); // Subtle highlight
-        g.fillEllipse(rx + 5, ry + 5, rw - 10, rw * 0.5f); // Smaller ellipse on the top half
-
-        // --- White Pointer Line ---
-        juce::Path pointerPath;
-        auto pointerLength = radius * 0.7f;  // Pointer length
-        auto pointerThickness = 2.0f;       // Pointer thickness
-        pointerPath.addRectangle(-pointerThickness * 0.5f, -radius, pointerThickness, pointerLength);
-        pointerPath.applyTransform(juce::AffineTransform::rotation(angle).translated(centerX, centerY));
-        g.setColour(juce::Colours::white);
-        g.fillPath(pointerPath);
-
-        if (slider.isMouseOverOrDragging())
-        {
-            g.setColour(juce::Colours::white.withAlpha(0.1f + sliderPos * 0.1f)); // Glow intensity
-            g.fillEllipse(rx - 8, ry - 8, rw + 16, rw + 16); // Glow extends slightly beyond the knob
-        }
-    }
+                          juce::Slider& slider) override;
 
     // Override the label drawing
     void drawLabel(juce::Graphics& g, juce::Label& label) override
@@ -81,4 +34,42 @@ public:
         g.setColour(juce::Colours::white); // Final clean white text
         g.drawFittedText(text, label.getLocalBounds().translated(0, 0), juce::Justification::centred, 1); // Centered text
     }
+
+private:
+    // The knob at numFrames evenly spaced positions, rendered the first time each one is
+    // needed. One filmstrip per radius, pixel scale, hover state and rotary range.
+    struct KnobFilmstripCache
+    {
+        static constexpr int numFrames = 128; // ~2 degrees per frame over the default 270 degree sweep
+        static constexpr int maxFilmstrips = 16; // Cleared when exceeded (e.g. after lots of resizing)
+
+        struct Key
+        {
+            int quarterPixelRadius;
+            int scalePercent;
+            bool isHovered;
+            float startAngle;
+            float endAngle;
+
+            bool operator<(const Key& other) const
+            {
+                return std::tie(quarterPixelRadius, scalePercent, isHovered, startAngle, endAngle)
+                     < std::tie(other.quarterPixelRadius, other.scalePercent, other.isHovered, other.startAngle, other.endAngle);
+            }
+        };
+
+        struct Filmstrip
+        {
+            std::array<juce::Image, numFrames> frames; // Null until first drawn
+        };
+
+        std::map<Key, Filmstrip> filmstrips;
+    };
+
+    // The original vector drawing of the knob, centred on (centreX, centreY)
+    static void drawKnob(juce::Graphics& g, float centreX, float centreY, float radius,
+                         float sliderPos, float angle, bool isHovered);
+
+    // Shared by every CustomLookAndFeel, so all open editors reuse the same frames
+    juce::SharedResourcePointer<KnobFilmstripCache> knobCache;
 };
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Linear per-sample smoothing of the gain parameter, like juce::SmoothedValue<float> with
+// ValueSmoothingTypes::Linear, except that it says how many ramp samples are left. That lets
+// processBlock split a block where the ramp ends: the ramp goes through the ramped kernels,
+// the rest (and every block while the knob isn't moving) through the constant-gain fast path.
+class GainRamp
+{
+public:
+    void reset(double sampleRate, double rampSeconds) noexcept
+    {
+        rampLength = juce::jmax(1, juce::roundToInt(sampleRate * rampSeconds));
+        setCurrentAndTargetValue(target);
+    }
+
+    void setCurrentAndTargetValue(float newValue) noexcept
+    {
+        current = target = newValue;
+        step = 0.0f;
+        remaining = 0;
+    }
+
+    // A new target restarts the ramp from wherever it is now, over the full ramp length
+    void setTargetValue(float newTarget) noexcept
+    {
+        if (newTarget == target)
+            return;
+
+        target = newTarget;
+        remaining = current == target ? 0 : rampLength;
+        step = (target - current) / (float)rampLength;
+    }
+
+    bool isSmoothing() const noexcept { return remaining > 0; }
+    int getRemainingSamples() const noexcept { return remaining; }
+    float getCurrentValue() const noexcept { return current; }
+    float getTargetValue() const noexcept { return target; }
+
+    // Moves numSamples along the ramp, stopping at the target, and returns the value reached
+    float skip(int numSamples) noexcept
+    {
+        if (numSamples >= remaining)
+        {
+            setCurrentAndTargetValue(target);
+            return target;
+        }
+
+        remaining -= numSamples;
+        current = target - step * (float)remaining; // From the target, so rounding never accumulates
+        return current;
+    }
+
+private:
+    float current = 1.0f, target = 1.0f, step = 0.0f;
+    int remaining = 0;
+    int rampLength = 1;
+};
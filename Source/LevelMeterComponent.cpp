@@ -2,76 +2,177 @@
 
 LevelMeterComponent::LevelMeterComponent()
 {
-    startTimerHz(30); // Update rate: 30 times per second
 }
 
-void LevelMeterComponent::setLevels(float left, float right)
+void LevelMeterComponent::setLevels(const float* newPeaks, const float* newMeanSquares, int numChannels)
 {
-    leftLevel = juce::jlimit(0.0f, 1.0f, left);  // Clamp to [0.0, 1.0]
-    rightLevel = juce::jlimit(0.0f, 1.0f, right); // Clamp to [0.0, 1.0]
+    numChannels = juce::jlimit(1, maxChannels, numChannels);
+
+    if (numChannels != numMeters)
+    {
+        numMeters = numChannels;
+        repaint(); // Layout changed, everything moves
+    }
+
+    for (int channel = 0; channel < numMeters; ++channel)
+    {
+        auto& meter = meters[(size_t)channel];
+        meter.pendingPeak = std::max(meter.pendingPeak, juce::jlimit(0.0f, 1.0f, newPeaks[channel])); // Clamp to [0.0, 1.0]
+        meter.pendingMeanSquareSum += newMeanSquares[channel];
+        ++meter.numPending;
+    }
 }
 
-void LevelMeterComponent::paint(juce::Graphics& g)
+juce::Rectangle<float> LevelMeterComponent::getBoxBounds(int channel) const
 {
     auto bounds = getLocalBounds();
 
-    // Define parameters for the meter boxes
-    auto boxWidth = bounds.getWidth() / 5;   // Narrower enclosing boxes
-    auto boxHeight = bounds.getHeight();    // Full height for the boxes
-    auto gap = bounds.getWidth() / 10;      // Space between the boxes
-    auto leftBoxX = (bounds.getWidth() / 2) - boxWidth - (gap / 2); // Left box position
-    auto rightBoxX = (bounds.getWidth() / 2) + (gap / 2);           // Right box position
-
-    // --- Draw Left Box ---
-    juce::Rectangle<float> leftBox(leftBoxX, 0, boxWidth, boxHeight);
-    g.setColour(juce::Colours::darkgrey.darker(0.3f)); // Slightly darker background for the box
-    g.fillRect(leftBox);
-
-    // Add shadow effect for the left box
-    juce::Rectangle<float> leftShadow(leftBox.getX(), leftBox.getBottom() - 5, leftBox.getWidth(), 5);
-    g.setColour(juce::Colours::black.withAlpha(0.2f)); // Subtle shadow
-    g.fillRect(leftShadow);
-
-    // Draw left meter fill
-    auto leftMeterHeight = boxHeight * leftLevel;
-    juce::Rectangle<float> leftMeter(leftBox.getX() + 5, boxHeight - leftMeterHeight, boxWidth - 10, leftMeterHeight);
-    g.setColour(juce::Colours::silver.withAlpha(leftLevel * 0.8f + 0.2f)); // Glow based on intensity
-    g.fillRect(leftMeter);
-
-    // Add border around the left meter
-    g.setColour(juce::Colours::black.withAlpha(0.5f));
-    g.drawRect(leftMeter, 1.0f);
-
-    // --- Draw Right Box ---
-    juce::Rectangle<float> rightBox(rightBoxX, 0, boxWidth, boxHeight);
-    g.setColour(juce::Colours::darkgrey.darker(0.3f)); // Slightly darker background for the box
-    g.fillRect(rightBox);
-
-    // Add shadow effect for the right box
-    juce::Rectangle<float> rightShadow(rightBox.getX(), rightBox.getBottom() - 5, rightBox.getWidth(), 5);
-    g.setColour(juce::Colours::black.withAlpha(0.2f)); // Subtle shadow
-    g.fillRect(rightShadow);
-
-    // Draw right meter fill
-    auto rightMeterHeight = boxHeight * rightLevel;
-    juce::Rectangle<float> rightMeter(rightBox.getX() + 5, boxHeight - rightMeterHeight, boxWidth - 10, rightMeterHeight);
-    g.setColour(juce::Colours::silver.withAlpha(rightLevel * 0.8f + 0.2f)); // Glow based on intensity
-    g.fillRect(rightMeter);
-
-    // Add border around the right meter
-    g.setColour(juce::Colours::black.withAlpha(0.5f));
-    g.drawRect(rightMeter, 1.0f);
+    // Define parameters for the meter boxes: with two channels this gives the
+    // original layout (boxes a fifth of the width, a tenth apart), more channels share the space
+    auto boxWidth = bounds.getWidth() / (2.5f * numMeters);            // Narrower enclosing boxes
+    auto gap = boxWidth / 2.0f;                                        // Space between the boxes
+    auto totalWidth = numMeters * boxWidth + (numMeters - 1) * gap;
+    auto firstBoxX = (bounds.getWidth() - totalWidth) / 2.0f;         // Leftmost box position
+
+    return { firstBoxX + channel * (boxWidth + gap), 0.0f, boxWidth, (float)bounds.getHeight() };
+}
+
+int LevelMeterComponent::levelToY(float level) const
+{
+    return juce::roundToInt(getHeight() * (1.0f - juce::jlimit(0.0f, 1.0f, level)));
+}
+
+void LevelMeterComponent::paint(juce::Graphics& g)
+{
+    auto boxHeight = (float)getHeight();
+
+    // Brightness depends on height rather than on the current level, so a bar that moves
+    // only changes the pixels between its old and new top (see tick)
+    juce::ColourGradient fillGradient(juce::Colours::silver.withAlpha(1.0f), 0.0f, 0.0f,
+                                      juce::Colours::silver.withAlpha(0.2f), 0.0f, boxHeight, false);
+
+    for (int channel = 0; channel < numMeters; ++channel)
+    {
+        const auto& meter = meters[(size_t)channel];
+        auto box = getBoxBounds(channel);
+
+        if (! g.clipRegionIntersects(box.getSmallestIntegerContainer()))
+            continue;
+
+        // --- Draw Box ---
+        g.setColour(juce::Colours::darkgrey.darker(0.3f)); // Slightly darker background for the box
+        g.fillRect(box);
+
+        // Add shadow effect for the box
+        juce::Rectangle<float> shadow(box.getX(), box.getBottom() - 5, box.getWidth(), 5);
+        g.setColour(juce::Colours::black.withAlpha(0.2f)); // Subtle shadow
+        g.fillRect(shadow);
+
+        // Draw peak fill (inset by 5 px each side, less when the boxes get narrow)
+        auto inset = juce::jmin(5.0f, box.getWidth() / 4.0f);
+        auto peakTop = (float)levelToY(meter.peak);
+        juce::Rectangle<float> peakBar(box.getX() + inset, peakTop, box.getWidth() - 2.0f * inset, boxHeight - peakTop);
+        g.setGradientFill(fillGradient);
+        g.fillRect(peakBar);
+
+        // Add border around the meter
+        g.setColour(juce::Colours::black.withAlpha(0.5f));
+        g.drawRect(peakBar, 1.0f);
+
+        // RMS as a brighter core inside the peak bar
+        auto rmsTop = (float)levelToY(std::sqrt(meter.meanSquare));
+        g.setColour(juce::Colours::white.withAlpha(0.35f));
+        g.fillRect(peakBar.getX() + inset, rmsTop, peakBar.getWidth() - 2.0f * inset, boxHeight - rmsTop);
+
+        // Peak-hold line
+        if (meter.hold > 0.0f)
+        {
+            g.setColour(juce::Colours::white);
+            g.fillRect(peakBar.getX(), (float)levelToY(meter.hold), peakBar.getWidth(), 2.0f);
+        }
+    }
 }
 
 
 void LevelMeterComponent::resized()
 {
-    // Adjust layout if needed
+    // The whole component gets repainted after a resize, so that's what's on screen now
+    for (auto& meter : meters)
+    {
+        meter.paintedPeakY = levelToY(meter.peak);
+        meter.paintedRmsY = levelToY(std::sqrt(meter.meanSquare));
+        meter.paintedHoldY = levelToY(meter.hold);
+    }
 }
 
-void LevelMeterComponent::timerCallback()
+void LevelMeterComponent::tick()
 {
-    // Smooth decay logic could be added here if levels should "fall" over time
-    repaint(); // Repaint the component regularly
+    const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    const float elapsed = lastTickTime > 0.0 ? (float)juce::jmin(0.25, now - lastTickTime) : 1.0f / 30.0f;
+    lastTickTime = now;
+
+    const float peakRelease = juce::Decibels::decibelsToGain(-peakReleaseDbPerSecond * elapsed);
+    const float rmsCoefficient = 1.0f - std::exp(-elapsed / rmsTimeConstantSeconds);
+
+    for (int channel = 0; channel < numMeters; ++channel)
+    {
+        auto& meter = meters[(size_t)channel];
+
+        // Instant attack, constant dB/s release
+        meter.peak = std::max(meter.peak * peakRelease, meter.pendingPeak);
+
+        // One-pole integration of power. A tick or two with nothing new (the audio callback and the
+        // timer don't line up exactly) keeps the last reading rather than counting as silence; any
+        // longer and the audio has stopped (transport stopped, host paused), so the bar falls.
+        if (meter.numPending > 0)
+        {
+            meter.lastMeanSquare = meter.pendingMeanSquareSum / (float)meter.numPending;
+            meter.numEmptyTicks = 0;
+        }
+        else if (++meter.numEmptyTicks > maxHeldTicks)
+        {
+            meter.lastMeanSquare = 0.0f;
+        }
+
+        meter.meanSquare += (meter.lastMeanSquare - meter.meanSquare) * rmsCoefficient;
+
+        // Hold the highest peak, then let it fall like the peak bar
+        if (meter.pendingPeak >= meter.hold)
+        {
+            meter.hold = meter.pendingPeak;
+            meter.holdTime = now;
+        }
+        else if (now - meter.holdTime > peakHoldSeconds)
+        {
+            meter.hold *= peakRelease;
+        }
+
+        // Flush denormal-sized tails so an idle meter settles to exactly zero
+        if (meter.peak < 1.0e-4f) meter.peak = 0.0f;
+        if (meter.meanSquare < 1.0e-8f) meter.meanSquare = 0.0f;
+        if (meter.hold < 1.0e-4f) meter.hold = 0.0f;
+
+        meter.pendingPeak = 0.0f;
+        meter.pendingMeanSquareSum = 0.0f;
+        meter.numPending = 0;
+
+        // Repaint only the rows between where each bar top was and where it is now
+        const int peakY = levelToY(meter.peak);
+        const int rmsY = levelToY(std::sqrt(meter.meanSquare));
+        const int holdY = levelToY(meter.hold);
+
+        if (peakY == meter.paintedPeakY && rmsY == meter.paintedRmsY && holdY == meter.paintedHoldY)
+            continue; // Idle or below one pixel of movement: nothing to redraw
+
+        const int top = std::min({ peakY, rmsY, holdY, meter.paintedPeakY, meter.paintedRmsY, meter.paintedHoldY });
+        const int bottom = std::max({ peakY, rmsY, holdY, meter.paintedPeakY, meter.paintedRmsY, meter.paintedHoldY });
+
+        meter.paintedPeakY = peakY;
+        meter.paintedRmsY = rmsY;
+        meter.paintedHoldY = holdY;
+
+        auto box = getBoxBounds(channel).getSmallestIntegerContainer();
+        repaint(box.getX(), top - 2, box.getWidth(), bottom - top + 5); // Margin for the border and the 2 px hold line
+    }
 }
 
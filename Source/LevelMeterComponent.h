@@ -2,21 +2,52 @@
 
 #include <JuceHeader.h>
 
-class LevelMeterComponent : public juce::Component, private juce::Timer
+class LevelMeterComponent : public juce::Component
 {
 public:
+    static constexpr int maxChannels = 64;
+
+    // Ballistics, applied on the message thread
+    static constexpr float peakReleaseDbPerSecond = 20.0f; // Peak bar falls this fast after the attack
+    static constexpr float rmsTimeConstantSeconds = 0.3f;  // RMS integration time
+    static constexpr double peakHoldSeconds = 1.5;         // Hold line stays put this long before falling
+    static constexpr int maxHeldTicks = 2;                 // Ticks with no new levels before the RMS bar decays to silence
+
     LevelMeterComponent();
-    void setLevels(float left, float right); // Set levels for the meters
+
+    // Block peaks and mean squares, one per channel; may be called several times between ticks
+    void setLevels(const float* newPeaks, const float* newMeanSquares, int numChannels);
+
+    // Runs the ballistics on what arrived since the last tick and repaints what moved.
+    // Called from the editor's timer right after it drains the telemetry, so there's one clock.
+    void tick();
+
     void paint(juce::Graphics& g) override;
     void resized() override;
 
 private:
-    void timerCallback() override;
+    juce::Rectangle<float> getBoxBounds(int channel) const; // Enclosing box of one meter
+    int levelToY(float level) const;                        // Pixel row of the top of a bar at this level
 
-    float leftLevel = 0.0f;  // Normalized value for the left meter (0.0 to 1.0)
-    float rightLevel = 0.0f; // Normalized value for the right meter (0.0 to 1.0)
+    struct Meter
+    {
+        float pendingPeak = 0.0f;          // Largest peak received since the last tick
+        float pendingMeanSquareSum = 0.0f; // Mean squares received since the last tick, averaged in tick()
+        int numPending = 0;
+        float lastMeanSquare = 0.0f;       // Fed to the RMS integrator on ticks with nothing new
+        int numEmptyTicks = 0;             // Ticks in a row with nothing new
 
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeterComponent)
-};
+        float peak = 0.0f;       // Normalized value for the meter (0.0 to 1.0)
+        float meanSquare = 0.0f; // Integrated power, the RMS bar is its square root
+        float hold = 0.0f;       // Peak-hold line
+        double holdTime = 0.0;   // When the hold line was last pushed up
+
+        int paintedPeakY = 0, paintedRmsY = 0, paintedHoldY = 0; // Rows shown on screen right now
+    };
 
+    std::array<Meter, maxChannels> meters;
+    int numMeters = 2; // Stereo until told otherwise
+    double lastTickTime = 0.0;
 
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeterComponent)
+};
@@ -0,0 +1,66 @@
+#include "LoadOverlayComponent.h"
+
+LoadOverlayComponent::LoadOverlayComponent(LoadProfiler& profilerToShow)
+    : profiler(profilerToShow)
+{
+    setOpaque(false); // Translucent panel, the waveform shows through
+}
+
+void LoadOverlayComponent::update()
+{
+    const auto statistics = profiler.getStatistics();
+
+    auto percent = [](float load) { return juce::String(100.0f * load, load < 0.1f ? 2 : 1) + "%"; };
+
+    juce::StringArray newLines;
+    newLines.add("DSP load  p50 " + percent(statistics.median) + "  p99 " + percent(statistics.percentile99));
+    newLines.add("max " + percent(statistics.worst) + "  over " + juce::String(juce::roundToInt(100.0f * LoadProfiler::nearDeadlineLoad))
+                 + "%: " + juce::String(statistics.numNearDeadline) + " / " + juce::String(statistics.numBlocks));
+
+    if (newLines != lines)
+    {
+        lines = newLines;
+        repaint();
+    }
+}
+
+void LoadOverlayComponent::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.6f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(11.0f));
+
+    auto area = getLocalBounds().reduced(6, 3);
+    const int lineHeight = area.getHeight() / juce::jmax(1, lines.size());
+
+    for (auto& line : lines)
+        g.drawText(line, area.removeFromTop(lineHeight), juce::Justification::centredLeft, true);
+}
+
+void LoadOverlayComponent::mouseUp(const juce::MouseEvent&)
+{
+    juce::PopupMenu menu;
+    menu.addItem("Reset", [this] { profiler.reset(); });
+    menu.addItem("Save Chrome trace...", [this] { saveTrace(); });
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
+}
+
+void LoadOverlayComponent::saveTrace()
+{
+    fileChooser = std::make_unique<juce::FileChooser>("Save processBlock trace",
+                                                      juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+                                                          .getChildFile("SatGain-trace.json"),
+                                                      "*.json");
+
+    fileChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting,
+                             [this](const juce::FileChooser& chooser)
+                             {
+                                 const auto file = chooser.getResult();
+
+                                 if (file != juce::File() && ! profiler.writeChromeTrace(file))
+                                     juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                                                                            "SatGain", "Couldn't write " + file.getFullPathName());
+                             });
+}
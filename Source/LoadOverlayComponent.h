@@ -0,0 +1,25 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LoadProfiler.h"
+
+// Optional readout of the processBlock load profile, drawn over the visualizer.
+// Click it for a menu to reset the numbers or save a Chrome trace of recent blocks.
+class LoadOverlayComponent : public juce::Component
+{
+public:
+    explicit LoadOverlayComponent(LoadProfiler& profilerToShow);
+
+    void update(); // Re-reads the profiler, repaints only if the text changed
+    void paint(juce::Graphics& g) override;
+    void mouseUp(const juce::MouseEvent& event) override;
+
+private:
+    void saveTrace();
+
+    LoadProfiler& profiler;
+    juce::StringArray lines;
+    std::unique_ptr<juce::FileChooser> fileChooser; // Kept alive while the async dialog is open
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoadOverlayComponent)
+};
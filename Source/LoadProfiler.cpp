@@ -0,0 +1,195 @@
+#include "LoadProfiler.h"
+
+LoadProfiler::LoadProfiler()
+    : ticksPerSecond((double)juce::Time::getHighResolutionTicksPerSecond()),
+      trace(new TraceEvent[(size_t)traceCapacity])
+{
+}
+
+void LoadProfiler::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void LoadProfiler::reset() noexcept
+{
+    resetRequested = true;
+}
+
+void LoadProfiler::clear() noexcept
+{
+    for (auto& count : histogram)
+        count.store(0, std::memory_order_relaxed);
+
+    histogramTotal = 0;
+    numBlocks = 0;
+    numNearDeadline = 0;
+    worst = 0.0f;
+    numTraced = 0;
+}
+
+//==============================================================================
+int LoadProfiler::getBin(float load) noexcept
+{
+    if (load <= minimumLoad)
+        return 0;
+
+    return juce::jlimit(1, numBins - 1, 1 + (int)(std::log2(load / minimumLoad) * binsPerOctave));
+}
+
+float LoadProfiler::getBinLoad(int bin) noexcept
+{
+    // Geometric centre of the bin
+    return bin == 0 ? minimumLoad : minimumLoad * std::exp2(((float)bin - 0.5f) / binsPerOctave);
+}
+
+void LoadProfiler::addBlock(juce::int64 startTicks, juce::int64 endTicks, int numSamples) noexcept
+{
+    if (resetRequested.exchange(false))
+        clear();
+
+    if (numSamples <= 0)
+        return;
+
+    const double seconds = (double)(endTicks - startTicks) / ticksPerSecond;
+    const float load = (float)(seconds * sampleRate.load(std::memory_order_relaxed) / numSamples);
+
+    histogram[(size_t)getBin(load)].fetch_add(1, std::memory_order_relaxed);
+
+    // This is the only writer, so halving with plain load/store pairs is safe
+    if (histogramTotal.fetch_add(1, std::memory_order_relaxed) + 1 >= windowBlocks)
+    {
+        juce::uint32 total = 0;
+
+        for (auto& count : histogram)
+        {
+            const auto halved = count.load(std::memory_order_relaxed) / 2;
+            count.store(halved, std::memory_order_relaxed);
+            total += halved;
+        }
+
+        histogramTotal.store(total, std::memory_order_relaxed);
+    }
+
+    numBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    if (load >= nearDeadlineLoad)
+        numNearDeadline.fetch_add(1, std::memory_order_relaxed);
+
+    if (load > worst.load(std::memory_order_relaxed))
+        worst.store(load, std::memory_order_relaxed);
+
+    const auto index = numTraced.load(std::memory_order_relaxed);
+    auto& event = trace[(size_t)(index % traceCapacity)];
+    event.startTicks.store(startTicks, std::memory_order_relaxed);
+    event.durationTicks.store(endTicks - startTicks, std::memory_order_relaxed);
+    event.numSamples.store(numSamples, std::memory_order_relaxed);
+    numTraced.store(index + 1, std::memory_order_release);
+}
+
+//==============================================================================
+float LoadProfiler::getPercentile(const std::array<juce::uint32, numBins>& counts, juce::uint64 total, float proportion) const noexcept
+{
+    const auto target = (juce::uint64)std::ceil((double)total * proportion);
+    juce::uint64 cumulative = 0;
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        cumulative += counts[(size_t)bin];
+
+        if (cumulative >= target)
+            return getBinLoad(bin);
+    }
+
+    return getBinLoad(numBins - 1);
+}
+
+LoadProfiler::Statistics LoadProfiler::getStatistics() const
+{
+    std::array<juce::uint32, numBins> counts;
+    juce::uint64 total = 0;
+
+    for (size_t bin = 0; bin < counts.size(); ++bin)
+    {
+        counts[bin] = histogram[bin].load(std::memory_order_relaxed);
+        total += counts[bin];
+    }
+
+    Statistics statistics;
+    statistics.numBlocks = numBlocks.load(std::memory_order_relaxed);
+    statistics.numNearDeadline = numNearDeadline.load(std::memory_order_relaxed);
+    statistics.worst = worst.load(std::memory_order_relaxed);
+
+    if (total > 0)
+    {
+        statistics.median = getPercentile(counts, total, 0.5f);
+        statistics.percentile99 = getPercentile(counts, total, 0.99f);
+    }
+
+    return statistics;
+}
+
+bool LoadProfiler::writeChromeTrace(const juce::File& file) const
+{
+    // Complete ("X") events for the blocks plus a counter track for the load, in microseconds
+    const auto end = numTraced.load(std::memory_order_acquire);
+    const auto start = juce::jmax((juce::int64)0, end - traceCapacity);
+    const double rate = sampleRate.load();
+
+    juce::Array<juce::var> events;
+
+    auto* threadNameArgs = new juce::DynamicObject();
+    threadNameArgs->setProperty("name", "Audio (processBlock)");
+
+    auto* threadName = new juce::DynamicObject();
+    threadName->setProperty("name", "thread_name");
+    threadName->setProperty("ph", "M");
+    threadName->setProperty("pid", 1);
+    threadName->setProperty("tid", 1);
+    threadName->setProperty("args", juce::var(threadNameArgs));
+    events.add(juce::var(threadName));
+
+    const juce::int64 firstTicks = end > start ? trace[(size_t)(start % traceCapacity)].startTicks.load() : 0;
+
+    for (auto index = start; index < end; ++index)
+    {
+        const auto& event = trace[(size_t)(index % traceCapacity)];
+        const auto numSamples = event.numSamples.load();
+        const double timestamp = 1.0e6 * (double)(event.startTicks.load() - firstTicks) / ticksPerSecond;
+        const double duration = 1.0e6 * (double)event.durationTicks.load() / ticksPerSecond;
+        const double load = numSamples > 0 ? duration * 1.0e-6 * rate / numSamples : 0.0;
+
+        auto* args = new juce::DynamicObject();
+        args->setProperty("samples", numSamples);
+        args->setProperty("deadlineUs", numSamples * 1.0e6 / rate);
+        args->setProperty("load", load);
+
+        auto* block = new juce::DynamicObject();
+        block->setProperty("name", load >= nearDeadlineLoad ? "processBlock (near deadline)" : "processBlock");
+        block->setProperty("ph", "X");
+        block->setProperty("pid", 1);
+        block->setProperty("tid", 1);
+        block->setProperty("ts", timestamp);
+        block->setProperty("dur", duration);
+        block->setProperty("args", juce::var(args));
+        events.add(juce::var(block));
+
+        auto* counterArgs = new juce::DynamicObject();
+        counterArgs->setProperty("percent", 100.0 * load);
+
+        auto* counter = new juce::DynamicObject();
+        counter->setProperty("name", "load");
+        counter->setProperty("ph", "C");
+        counter->setProperty("pid", 1);
+        counter->setProperty("ts", timestamp);
+        counter->setProperty("args", juce::var(counterArgs));
+        events.add(juce::var(counter));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("traceEvents", events);
+    root->setProperty("displayTimeUnit", "ns");
+
+    return file.replaceWithText(juce::JSON::toString(juce::var(root), true));
+}
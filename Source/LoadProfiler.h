@@ -0,0 +1,91 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Times every processBlock call against its real-time deadline (block length / sample rate).
+// The audio thread only does relaxed atomic adds into a rolling histogram and a trace ring,
+// so it never blocks; the editor reads percentiles from it and can dump a Chrome trace
+// (chrome://tracing or ui.perfetto.dev) of the most recent blocks.
+class LoadProfiler
+{
+public:
+    // Loads are fractions of the block's deadline: 1.0 means the block took as long as its audio lasts
+    struct Statistics
+    {
+        juce::int64 numBlocks = 0;       // Since the last reset
+        juce::int64 numNearDeadline = 0; // Blocks at or above nearDeadlineLoad
+        float median = 0.0f;             // Rolling, over roughly the last windowBlocks blocks
+        float percentile99 = 0.0f;
+        float worst = 0.0f;              // Since the last reset
+    };
+
+    static constexpr float nearDeadlineLoad = 0.8f;
+    static constexpr int traceCapacity = 8192;  // Blocks kept for the trace dump
+    static constexpr juce::uint32 windowBlocks = 16384; // Histogram counts halve after this many, so old blocks fade out
+
+    LoadProfiler();
+
+    void prepare(double sampleRate);
+    void reset() noexcept; // Safe from any thread; the audio thread clears everything on its next block
+
+    Statistics getStatistics() const;
+    bool writeChromeTrace(const juce::File& file) const;
+
+    // Put one of these at the top of processBlock
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(LoadProfiler& p, int numSamplesToProcess) noexcept
+            : profiler(p), numSamples(numSamplesToProcess), startTicks(juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedBlock() noexcept
+        {
+            profiler.addBlock(startTicks, juce::Time::getHighResolutionTicks(), numSamples);
+        }
+
+    private:
+        LoadProfiler& profiler;
+        const int numSamples;
+        const juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+private:
+    void addBlock(juce::int64 startTicks, juce::int64 endTicks, int numSamples) noexcept;
+    void clear() noexcept;
+
+    // Logarithmic bins, 8 per octave from 0.01% to about 1300% of the deadline
+    static constexpr float minimumLoad = 1.0e-4f;
+    static constexpr int binsPerOctave = 8;
+    static constexpr int numBins = 17 * binsPerOctave + 1;
+
+    static int getBin(float load) noexcept;
+    static float getBinLoad(int bin) noexcept;
+    float getPercentile(const std::array<juce::uint32, numBins>& counts, juce::uint64 total, float proportion) const noexcept;
+
+    struct TraceEvent
+    {
+        std::atomic<juce::int64> startTicks{ 0 };
+        std::atomic<juce::int64> durationTicks{ 0 };
+        std::atomic<int> numSamples{ 0 };
+    };
+
+    std::atomic<double> sampleRate{ 44100.0 };
+    const double ticksPerSecond;
+
+    std::array<std::atomic<juce::uint32>, numBins> histogram{};
+    std::atomic<juce::uint32> histogramTotal{ 0 };
+
+    std::atomic<juce::int64> numBlocks{ 0 };
+    std::atomic<juce::int64> numNearDeadline{ 0 };
+    std::atomic<float> worst{ 0.0f };
+    std::atomic<bool> resetRequested{ false };
+
+    std::unique_ptr<TraceEvent[]> trace; // Ring of the last traceCapacity blocks
+    std::atomic<juce::int64> numTraced{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoadProfiler)
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Single-producer, single-consumer queue of trivially copyable items.
+// Storage is allocated once in the constructor; push and pop never block,
+// lock or allocate, so the audio thread can write while the message thread reads.
+template <typename ItemType>
+class LockFreeFifo
+{
+public:
+    explicit LockFreeFifo(int capacity)
+        : fifo(capacity), items((size_t)capacity)
+    {
+    }
+
+    // Producer side. Returns false (and drops the item) when the queue is full.
+    bool push(const ItemType& item) noexcept
+    {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 > 0)
+        {
+            items[(size_t)scope.startIndex1] = item;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Consumer side. Returns false when there is nothing to read.
+    bool pop(ItemType& item) noexcept
+    {
+        const auto scope = fifo.read(1);
+
+        if (scope.blockSize1 > 0)
+        {
+            item = items[(size_t)scope.startIndex1];
+            return true;
+        }
+
+        return false;
+    }
+
+    // Consumer side. Throws away everything currently queued.
+    void discardAll() noexcept
+    {
+        fifo.read(fifo.getNumReady());
+    }
+
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+
+private:
+    juce::AbstractFifo fifo;
+    std::vector<ItemType> items;
+
+    JUCE_DECLARE_NON_COPYABLE(LockFreeFifo)
+};
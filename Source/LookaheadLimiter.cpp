@@ -0,0 +1,139 @@
+#include "LookaheadLimiter.h"
+#include <numeric>
+
+void LookaheadLimiter::prepare(double newSampleRate, int numChannels)
+{
+    sampleRate = newSampleRate;
+    numChannelsPrepared = juce::jmax(0, numChannels);
+    maximumLookahead = juce::jmax(1, (int)std::ceil(maximumLookaheadMs * 0.001 * sampleRate));
+    releaseCoefficient = (float)(1.0 - std::exp(-1.0 / (releaseSeconds * sampleRate)));
+
+    delay.assign((size_t)(numChannelsPrepared * maximumLookahead), 0.0f);
+    dequeIndices.assign((size_t)(maximumLookahead + 1), 0);
+    dequeGains.assign((size_t)(maximumLookahead + 1), 1.0f);
+    history.assign((size_t)(maximumLookahead + 1), 1.0f);
+
+    lookahead = juce::jlimit(1, maximumLookahead, lookahead);
+    reset();
+}
+
+void LookaheadLimiter::reset()
+{
+    std::fill(delay.begin(), delay.end(), 0.0f);
+    delayPosition = 0;
+
+    dequeFront = 0;
+    dequeBack = 0;
+    dequeSize = 0;
+    sampleIndex = 0;
+
+    released = 1.0f;
+    std::fill(history.begin(), history.end(), 1.0f);
+    historyPosition = 0;
+    historySum = lookahead + 1;
+}
+
+void LookaheadLimiter::setLookaheadMs(double milliseconds)
+{
+    const int newLookahead = juce::jlimit(1, juce::jmax(1, maximumLookahead), juce::roundToInt(milliseconds * 0.001 * sampleRate));
+
+    if (newLookahead == lookahead)
+        return;
+
+    lookahead = newLookahead;
+    reset();
+}
+
+void LookaheadLimiter::process(juce::dsp::AudioBlock<float> block) noexcept
+{
+    const int numChannels = juce::jmin((int)block.getNumChannels(), numChannelsPrepared);
+    const int numSamples = (int)block.getNumSamples();
+    const int window = lookahead + 1;
+    const int dequeCapacity = (int)dequeGains.size();
+
+    float gains[chunkLength];
+
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += chunkLength)
+    {
+        const int chunkSamples = juce::jmin(chunkLength, numSamples - chunkStart);
+
+        // Loudest channel at each sample (plain loops, so the compiler vectorises them)
+        std::fill(gains, gains + chunkSamples, 0.0f);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float* data = block.getChannelPointer((size_t)channel) + chunkStart;
+
+            for (int i = 0; i < chunkSamples; ++i)
+                gains[i] = juce::jmax(gains[i], std::abs(data[i]));
+        }
+
+        // Gain envelope, O(1) per sample
+        for (int i = 0; i < chunkSamples; ++i)
+        {
+            const float required = gains[i] > ceiling ? ceiling / gains[i] : 1.0f;
+
+            // Drop the front once it leaves the window, before pushing, so the deque never holds more
+            // than window entries; then larger gains from the back (they can never be the minimum again)
+            if (dequeSize > 0 && dequeIndices[(size_t)dequeFront] <= sampleIndex - window)
+            {
+                dequeFront = dequeFront + 1 == dequeCapacity ? 0 : dequeFront + 1;
+                --dequeSize;
+            }
+
+            while (dequeSize > 0)
+            {
+                const int last = dequeBack == 0 ? dequeCapacity - 1 : dequeBack - 1;
+
+                if (dequeGains[(size_t)last] < required)
+                    break;
+
+                dequeBack = last;
+                --dequeSize;
+            }
+
+            jassert(dequeSize < dequeCapacity);
+            dequeIndices[(size_t)dequeBack] = sampleIndex;
+            dequeGains[(size_t)dequeBack] = required;
+            dequeBack = dequeBack + 1 == dequeCapacity ? 0 : dequeBack + 1;
+            ++dequeSize;
+
+            ++sampleIndex;
+
+            // Attack is instant here (the averaging below fades it in); release is a one-pole back up
+            const float held = dequeGains[(size_t)dequeFront];
+            released = held < released ? held : released + releaseCoefficient * (held - released);
+
+            historySum += released - history[(size_t)historyPosition];
+            history[(size_t)historyPosition] = released;
+
+            // Re-add the window from scratch once per lap, so the running sum's rounding never builds up
+            if (++historyPosition == window)
+            {
+                historyPosition = 0;
+                historySum = std::accumulate(history.begin(), history.begin() + window, 0.0);
+            }
+
+            gains[i] = (float)(historySum / window);
+        }
+
+        // Delay each channel by the lookahead and apply the gain. The average can round an ulp above
+        // the gain the sample needs, so the result is clamped to the ceiling as well.
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* data = block.getChannelPointer((size_t)channel) + chunkStart;
+            float* ring = delay.data() + channel * maximumLookahead;
+            int position = delayPosition;
+
+            for (int i = 0; i < chunkSamples; ++i)
+            {
+                const float delayed = ring[position];
+                ring[position] = data[i];
+                data[i] = juce::jlimit(-ceiling, ceiling, delayed * gains[i]);
+                position = position + 1 == lookahead ? 0 : position + 1;
+            }
+        }
+
+        delayPosition = (delayPosition + chunkSamples) % lookahead;
+    }
+}
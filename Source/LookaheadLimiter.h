@@ -0,0 +1,54 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Brickwall output limiter with lookahead, the last stage before the meters. The signal is
+// delayed by the lookahead and the gain needed to keep the loudest channel under the ceiling
+// is computed ahead of it: a sliding-window minimum of the required gain (a monotonic deque,
+// amortised O(1) per sample whatever the window), a release, then a moving average over the
+// same window so the gain fades in over the lookahead instead of stepping.
+// Because every averaged gain is already at or below what the delayed sample needs, the
+// output never exceeds the ceiling. The lookahead is the latency.
+// Everything is allocated in prepare(); the other calls never allocate.
+class LookaheadLimiter
+{
+public:
+    static constexpr float ceiling = 1.0f;              // 0 dBFS
+    static constexpr double maximumLookaheadMs = 10.0;
+    static constexpr double releaseSeconds = 0.05;
+
+    LookaheadLimiter() = default;
+
+    void prepare(double sampleRate, int numChannels);
+    void reset(); // Clears the delay line and the gain history
+
+    void setLookaheadMs(double milliseconds); // Restarts the limiter if the length in samples changes; so does the latency
+    int getLatencySamples() const noexcept { return lookahead; }
+
+    void process(juce::dsp::AudioBlock<float> block) noexcept;
+
+private:
+    static constexpr int chunkLength = 256; // Gain envelope is worked out this many samples at a time, on the stack
+
+    double sampleRate = 44100.0;
+    int numChannelsPrepared = 0;
+    int maximumLookahead = 0;
+    int lookahead = 0;          // Samples of delay; the windows are lookahead + 1 long
+    float releaseCoefficient = 0.0f;
+
+    std::vector<float> delay;   // Per channel ring of lookahead samples, channel-major with maximumLookahead stride
+    int delayPosition = 0;
+
+    // Sliding minimum of the required gain: (sample index, gain) pairs with increasing gains
+    std::vector<juce::int64> dequeIndices;
+    std::vector<float> dequeGains;
+    int dequeFront = 0, dequeBack = 0, dequeSize = 0; // dequeBack is the next free slot
+    juce::int64 sampleIndex = 0;
+
+    float released = 1.0f;      // Held gain after the release
+    std::vector<float> history; // Last lookahead + 1 released gains, for the moving average
+    int historyPosition = 0;
+    double historySum = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LookaheadLimiter)
+};
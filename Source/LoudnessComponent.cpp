@@ -0,0 +1,46 @@
+#include "LoudnessComponent.h"
+
+LoudnessComponent::LoudnessComponent(LoudnessMeter& meterToShow)
+    : meter(meterToShow)
+{
+    setOpaque(false); // Translucent panel, the waveform shows through
+}
+
+void LoudnessComponent::update()
+{
+    const auto results = meter.getResults();
+
+    auto format = [](float value) { return std::isfinite(value) ? juce::String(value, 1) : juce::String("--"); };
+
+    juce::StringArray newLines;
+    newLines.add("M " + format(results.momentary) + "  S " + format(results.shortTerm) + " LUFS");
+    newLines.add("I " + format(results.integrated) + " LUFS  TP " + format(results.truePeak));
+
+    if (newLines != lines)
+    {
+        lines = newLines;
+        repaint();
+    }
+}
+
+void LoudnessComponent::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.6f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(11.0f));
+
+    auto area = getLocalBounds().reduced(6, 3);
+    const int lineHeight = area.getHeight() / juce::jmax(1, lines.size());
+
+    for (auto& line : lines)
+        g.drawText(line, area.removeFromTop(lineHeight), juce::Justification::centredLeft, true);
+}
+
+void LoudnessComponent::mouseUp(const juce::MouseEvent&)
+{
+    juce::PopupMenu menu;
+    menu.addItem("Reset integrated and true peak", [this] { meter.reset(); });
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LoudnessMeter.h"
+
+// Loudness readout drawn over the corner of the visualizer: momentary, short-term and
+// integrated LUFS and true peak. Click it to reset the integrated value and the true peak.
+class LoudnessComponent : public juce::Component
+{
+public:
+    explicit LoudnessComponent(LoudnessMeter& meterToShow);
+
+    void update(); // Re-reads the meter, repaints only if the text changed
+    void paint(juce::Graphics& g) override;
+    void mouseUp(const juce::MouseEvent& event) override;
+
+private:
+    LoudnessMeter& meter;
+    juce::StringArray lines;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessComponent)
+};
@@ -0,0 +1,388 @@
+#include "LoudnessMeter.h"
+
+LoudnessMeter::LoudnessMeter()
+{
+    // 4x interpolation filter: Hann-windowed sinc, cut off at the original Nyquist, split into
+    // its polyphase components. Each phase sums to about 1, so the interpolated signal keeps its level.
+    constexpr int numTaps = truePeakFactor * tapsPerPhase;
+
+    for (int phase = 0; phase < truePeakFactor; ++phase)
+    {
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+        {
+            const int n = tap * truePeakFactor + phase;
+            const double t = (n - (numTaps - 1) * 0.5) / truePeakFactor;
+            const double sinc = t == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * t) / (juce::MathConstants<double>::pi * t);
+            const double hann = 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * (n + 0.5) / numTaps);
+            truePeakTaps[phase][tap] = (float)(sinc * hann);
+        }
+    }
+}
+
+LoudnessMeter::~LoudnessMeter()
+{
+    release();
+}
+
+float LoudnessMeter::getChannelWeight(juce::AudioChannelSet::ChannelType type) noexcept
+{
+    switch (type)
+    {
+        case juce::AudioChannelSet::LFE:
+        case juce::AudioChannelSet::LFE2:
+            return 0.0f;
+
+        case juce::AudioChannelSet::leftSurround:
+        case juce::AudioChannelSet::rightSurround:
+        case juce::AudioChannelSet::leftSurroundSide:
+        case juce::AudioChannelSet::rightSurroundSide:
+        case juce::AudioChannelSet::leftSurroundRear:
+        case juce::AudioChannelSet::rightSurroundRear:
+            return 1.41f;
+
+        default:
+            return 1.0f;
+    }
+}
+
+void LoudnessMeter::prepare(double newSampleRate, const juce::AudioChannelSet& layout)
+{
+    release(); // The worker keeps off everything below until the meter is added back
+
+    const int newNumChannels = layout.size();
+    const bool formatChanged = newSampleRate != sampleRate || newNumChannels != numChannels;
+
+    weights.resize((size_t)newNumChannels);
+
+    for (int channel = 0; channel < newNumChannels; ++channel)
+        weights[(size_t)channel] = getChannelWeight(layout.getTypeOfChannel(channel));
+
+    if (formatChanged)
+    {
+        sampleRate = newSampleRate;
+        numChannels = newNumChannels;
+        numGroups = (numChannels + SimdFloat::size - 1) / SimdFloat::size;
+        groups.resize((size_t)numGroups);
+        subBlockEnergy.resize((size_t)numChannels);
+        queue.assign((size_t)numChannels * queueCapacity, 0.0f);
+        subBlockLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+
+        // BS.1770 K-weighting, re-derived for this sample rate: a high-shelf for the head, then the RLB high-pass
+        {
+            const double k = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+            const double q = 0.7071752369554196;
+            const double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+            shelf = { (float)((vh + vb * k / q + k * k) / a0), (float)(2.0 * (k * k - vh) / a0), (float)((vh - vb * k / q + k * k) / a0),
+                      (float)(2.0 * (k * k - 1.0) / a0), (float)((1.0 - k / q + k * k) / a0) };
+        }
+
+        {
+            const double k = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+            const double q = 0.5003270373238773;
+            const double a0 = 1.0 + k / q + k * k;
+            highPass = { 1.0f, -2.0f, 1.0f, (float)(2.0 * (k * k - 1.0) / a0), (float)((1.0 - k / q + k * k) / a0) };
+        }
+
+        clear();
+    }
+
+    fifo.reset();
+    worker->add(*this);
+}
+
+void LoudnessMeter::release()
+{
+    worker->remove(*this);
+}
+
+void LoudnessMeter::reset() noexcept
+{
+    resetRequested.store(true);
+}
+
+void LoudnessMeter::clear()
+{
+    const auto zero = SimdFloat::broadcast(0.0f);
+
+    for (auto& group : groups)
+    {
+        group.shelf1 = group.shelf2 = group.highPass1 = group.highPass2 = zero;
+        std::fill(std::begin(group.history), std::end(group.history), zero);
+        group.historyPosition = 0;
+        group.peak = zero;
+    }
+
+    std::fill(subBlockEnergy.begin(), subBlockEnergy.end(), 0.0);
+    subBlockPosition = 0;
+    subBlockPowers.fill(0.0);
+    numSubBlocks = 0;
+    gatedCounts.fill(0);
+    gatedEnergies.fill(0.0);
+
+    momentary.store(-std::numeric_limits<float>::infinity());
+    shortTerm.store(-std::numeric_limits<float>::infinity());
+    integrated.store(-std::numeric_limits<float>::infinity());
+    truePeak.store(-std::numeric_limits<float>::infinity());
+}
+
+LoudnessMeter::Results LoudnessMeter::getResults() const noexcept
+{
+    return { momentary.load(), shortTerm.load(), integrated.load(), truePeak.load() };
+}
+
+//==============================================================================
+void LoudnessMeter::push(const float* const* channels, int numChannelsToPush, int numSamples) noexcept
+{
+    if (fifo.getFreeSpace() < numSamples)
+        return;
+
+    const auto scope = fifo.write(numSamples);
+    const int count = juce::jmin(numChannelsToPush, numChannels);
+
+    for (int channel = 0; channel < count; ++channel)
+    {
+        auto* dest = queue.data() + (size_t)channel * queueCapacity;
+        std::copy_n(channels[channel], scope.blockSize1, dest + scope.startIndex1);
+        std::copy_n(channels[channel] + scope.blockSize1, scope.blockSize2, dest + scope.startIndex2);
+    }
+
+    // Channels the host didn't give us count as silence
+    for (int channel = count; channel < numChannels; ++channel)
+    {
+        auto* dest = queue.data() + (size_t)channel * queueCapacity;
+        std::fill_n(dest + scope.startIndex1, scope.blockSize1, 0.0f);
+        std::fill_n(dest + scope.startIndex2, scope.blockSize2, 0.0f);
+    }
+}
+
+//==============================================================================
+LoudnessMeter::Worker::Worker()
+    : juce::Thread("SatGain loudness")
+{
+    startThread();
+}
+
+LoudnessMeter::Worker::~Worker()
+{
+    stopThread(2000);
+}
+
+void LoudnessMeter::Worker::add(LoudnessMeter& meter)
+{
+    const juce::ScopedLock sl(lock);
+    meters.addIfNotAlreadyThere(&meter);
+    notify();
+}
+
+void LoudnessMeter::Worker::remove(LoudnessMeter& meter)
+{
+    const juce::ScopedLock sl(lock);
+    meters.removeFirstMatchingValue(&meter);
+}
+
+void LoudnessMeter::Worker::run()
+{
+    while (! threadShouldExit())
+    {
+        bool anyMeters = false;
+
+        {
+            const juce::ScopedLock sl(lock);
+
+            for (auto* meter : meters)
+                meter->service();
+
+            anyMeters = ! meters.isEmpty();
+        }
+
+        // With nothing prepared, sleep until add() or stopThread() wakes us
+        wait(anyMeters ? 10 : -1);
+    }
+}
+
+void LoudnessMeter::service()
+{
+    if (resetRequested.exchange(false))
+        clear();
+
+    const auto scope = fifo.read(fifo.getNumReady());
+
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+        return;
+
+    processChunk(scope.startIndex1, scope.blockSize1);
+    processChunk(scope.startIndex2, scope.blockSize2);
+    publish();
+}
+
+void LoudnessMeter::processChunk(int start, int numFrames)
+{
+    // Split at the 100 ms boundaries, where the energies are gathered up
+    while (numFrames > 0)
+    {
+        const int count = juce::jmin(numFrames, subBlockLength - subBlockPosition);
+
+        for (int group = 0; group < numGroups; ++group)
+            processGroup(group, start, count);
+
+        subBlockPosition += count;
+        start += count;
+        numFrames -= count;
+
+        if (subBlockPosition == subBlockLength)
+            finishSubBlock();
+    }
+}
+
+void LoudnessMeter::processGroup(int groupIndex, int start, int numFrames)
+{
+    auto& group = groups[(size_t)groupIndex];
+    const int firstChannel = groupIndex * SimdFloat::size;
+    const int lanesInGroup = juce::jmin(SimdFloat::size, numChannels - firstChannel);
+
+    const auto sb0 = SimdFloat::broadcast(shelf.b0), sb1 = SimdFloat::broadcast(shelf.b1), sb2 = SimdFloat::broadcast(shelf.b2);
+    const auto sa1 = SimdFloat::broadcast(shelf.a1), sa2 = SimdFloat::broadcast(shelf.a2);
+    const auto hb0 = SimdFloat::broadcast(highPass.b0), hb1 = SimdFloat::broadcast(highPass.b1), hb2 = SimdFloat::broadcast(highPass.b2);
+    const auto ha1 = SimdFloat::broadcast(highPass.a1), ha2 = SimdFloat::broadcast(highPass.a2);
+
+    alignas(64) float tile[tileLength][SimdFloat::size];
+
+    for (int tileStart = 0; tileStart < numFrames; tileStart += tileLength)
+    {
+        const int tileFrames = juce::jmin(tileLength, numFrames - tileStart);
+
+        // Interleave the group's channels, one per lane
+        for (int i = 0; i < tileFrames; ++i)
+            for (int lane = 0; lane < SimdFloat::size; ++lane)
+                tile[i][lane] = lane < lanesInGroup ? queue[(size_t)(firstChannel + lane) * queueCapacity + (size_t)(start + tileStart + i)] : 0.0f;
+
+        auto energy = SimdFloat::broadcast(0.0f);
+
+        for (int i = 0; i < tileFrames; ++i)
+        {
+            const auto x = SimdFloat::load(tile[i]);
+
+            // True peak: the sample itself plus three interpolated points after it
+            group.history[group.historyPosition] = x;
+            group.history[group.historyPosition + tapsPerPhase] = x;
+            group.historyPosition = (group.historyPosition + 1) % tapsPerPhase;
+
+            const auto* taps = group.history + group.historyPosition; // Oldest first
+
+            for (int phase = 0; phase < truePeakFactor; ++phase)
+            {
+                auto y = SimdFloat::broadcast(0.0f);
+
+                for (int tap = 0; tap < tapsPerPhase; ++tap)
+                    y = y + taps[tapsPerPhase - 1 - tap] * SimdFloat::broadcast(truePeakTaps[phase][tap]);
+
+                group.peak = SimdFloat::max(group.peak, SimdFloat::abs(y));
+            }
+
+            group.peak = SimdFloat::max(group.peak, SimdFloat::abs(x));
+
+            // K-weighting
+            const auto s = sb0 * x + group.shelf1;
+            group.shelf1 = sb1 * x - sa1 * s + group.shelf2;
+            group.shelf2 = sb2 * x - sa2 * s;
+
+            const auto k = hb0 * s + group.highPass1;
+            group.highPass1 = hb1 * s - ha1 * k + group.highPass2;
+            group.highPass2 = hb2 * s - ha2 * k;
+
+            energy = energy + k * k;
+        }
+
+        alignas(64) float lanes[SimdFloat::size];
+        energy.store(lanes);
+
+        for (int lane = 0; lane < lanesInGroup; ++lane)
+            subBlockEnergy[(size_t)(firstChannel + lane)] += lanes[lane];
+    }
+}
+
+void LoudnessMeter::finishSubBlock()
+{
+    double power = 0.0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        power += weights[(size_t)channel] * subBlockEnergy[(size_t)channel] / subBlockLength;
+
+    std::fill(subBlockEnergy.begin(), subBlockEnergy.end(), 0.0);
+    subBlockPosition = 0;
+    subBlockPowers[(size_t)(numSubBlocks % subBlocksPerShortTerm)] = power;
+    ++numSubBlocks;
+
+    auto meanOfLast = [this](int count)
+        {
+            count = (int)juce::jmin((juce::int64)count, numSubBlocks);
+            double sum = 0.0;
+
+            for (int i = 1; i <= count; ++i)
+                sum += subBlockPowers[(size_t)((numSubBlocks - i) % subBlocksPerShortTerm)];
+
+            return sum / count;
+        };
+
+    const double momentaryPower = meanOfLast(subBlocksPerMomentary);
+    momentary.store(energyToLoudness(momentaryPower));
+    shortTerm.store(energyToLoudness(meanOfLast(subBlocksPerShortTerm)));
+
+    // Every 400 ms block, overlapped by 75%, goes into the gating histogram if it's above the absolute gate
+    if (numSubBlocks >= subBlocksPerMomentary)
+    {
+        const float loudness = energyToLoudness(momentaryPower);
+
+        if (loudness > absoluteGate)
+        {
+            const int bin = juce::jlimit(0, numBins - 1, (int)((loudness - absoluteGate) / binWidth));
+            ++gatedCounts[(size_t)bin];
+            gatedEnergies[(size_t)bin] += momentaryPower;
+        }
+    }
+}
+
+void LoudnessMeter::publish()
+{
+    // Integrated: mean of the blocks above the absolute gate sets the relative gate, then the
+    // mean of the blocks above that is the answer
+    juce::uint64 count = 0;
+    double energy = 0.0;
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        count += gatedCounts[(size_t)bin];
+        energy += gatedEnergies[(size_t)bin];
+    }
+
+    if (count > 0)
+    {
+        const float threshold = energyToLoudness(energy / (double)count) + relativeGate;
+        const int firstBin = juce::jlimit(0, numBins - 1, (int)std::ceil((threshold - absoluteGate) / binWidth));
+
+        count = 0;
+        energy = 0.0;
+
+        for (int bin = firstBin; bin < numBins; ++bin)
+        {
+            count += gatedCounts[(size_t)bin];
+            energy += gatedEnergies[(size_t)bin];
+        }
+
+        if (count > 0)
+            integrated.store(energyToLoudness(energy / (double)count));
+    }
+
+    float peak = 0.0f;
+    for (auto& group : groups)
+        peak = juce::jmax(peak, group.peak.reduceMax());
+
+    truePeak.store(juce::Decibels::gainToDecibels(peak, -std::numeric_limits<float>::infinity()));
+}
+
+float LoudnessMeter::energyToLoudness(double energy) noexcept
+{
+    return energy > 0.0 ? (float)(-0.691 + 10.0 * std::log10(energy)) : -std::numeric_limits<float>::infinity();
+}
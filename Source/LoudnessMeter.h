@@ -0,0 +1,123 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SimdFloat.h"
+
+// ITU-R BS.1770 / EBU R128 loudness and true peak of the plugin's output.
+// The audio thread only copies each block into a lock-free queue. One worker thread, shared by
+// every instance in the process, does the K-weighting, the 100 ms energy blocks, the gating and
+// the 4x true-peak interpolation, with channels in SIMD lanes, and publishes the results through
+// atomics. Every channel of the layout is measured, weighted as BS.1770 says (see getChannelWeight).
+// The numbers live in the processor, so closing and reopening the editor doesn't reset them.
+class LoudnessMeter
+{
+public:
+    static constexpr int queueCapacity = 32768; // Frames per channel; the worker polls every 10 ms
+
+    // LUFS, or -inf until there is enough signal (the integrated value needs a gated block)
+    struct Results
+    {
+        float momentary = -std::numeric_limits<float>::infinity();  // 400 ms
+        float shortTerm = -std::numeric_limits<float>::infinity();  // 3 s
+        float integrated = -std::numeric_limits<float>::infinity(); // Since the last reset, gated
+        float truePeak = -std::numeric_limits<float>::infinity();   // dBTP, since the last reset
+    };
+
+    LoudnessMeter();
+    ~LoudnessMeter();
+
+    // Message thread. Sizes the queue for the layout and hands the meter to the worker; keeps the
+    // measurement unless the rate or the number of channels changed.
+    void prepare(double sampleRate, const juce::AudioChannelSet& layout);
+    void release(); // Takes the meter off the worker, keeps the results
+
+    // Audio thread. Never blocks; the block is dropped if the worker has fallen that far behind.
+    void push(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    Results getResults() const noexcept;
+    void reset() noexcept; // Any thread; the worker clears everything before its next block
+
+    // BS.1770 weight of a channel: 0 for LFE, 1.41 for surrounds, 1 otherwise
+    static float getChannelWeight(juce::AudioChannelSet::ChannelType type) noexcept;
+
+private:
+    // The thread behind every meter. Meters are added and removed on the message thread; the lock
+    // is only ever taken there and on the worker, never by push().
+    class Worker : private juce::Thread
+    {
+    public:
+        Worker();
+        ~Worker() override;
+
+        void add(LoudnessMeter& meter);
+        void remove(LoudnessMeter& meter); // Once this returns the worker no longer touches the meter
+
+    private:
+        void run() override;
+
+        juce::CriticalSection lock;
+        juce::Array<LoudnessMeter*> meters;
+    };
+
+    void service(); // Worker: drains the queue and updates the readings
+    void clear();
+    void processChunk(int start, int numFrames);
+    void processGroup(int group, int start, int numFrames);
+    void finishSubBlock();
+    void publish();
+
+    static float energyToLoudness(double energy) noexcept;
+
+    // True-peak interpolator: 4 phases of a 48-tap windowed sinc
+    static constexpr int truePeakFactor = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int tileLength = 64;
+
+    // Gating histogram for the integrated loudness, 0.1 LU bins from the absolute gate up
+    static constexpr float absoluteGate = -70.0f;
+    static constexpr float relativeGate = -10.0f;
+    static constexpr float binWidth = 0.1f;
+    static constexpr int numBins = 900; // -70 to +20 LUFS
+    static constexpr int subBlocksPerMomentary = 4;  // 100 ms sub-blocks
+    static constexpr int subBlocksPerShortTerm = 30;
+
+    // Filter and interpolator state of one vector of channels
+    struct Group
+    {
+        SimdFloat shelf1, shelf2, highPass1, highPass2; // Transposed direct form II
+        SimdFloat history[2 * tapsPerPhase];            // Doubled ring, so taps read contiguously
+        int historyPosition = 0;
+        SimdFloat peak;
+    };
+
+    double sampleRate = 0.0;
+    int numChannels = 0;
+    int numGroups = 0;
+    std::vector<float> weights;
+
+    // Queue, channel-planar, numChannels * queueCapacity
+    juce::AbstractFifo fifo{ queueCapacity };
+    std::vector<float> queue;
+
+    // Worker only
+    struct { float b0, b1, b2, a1, a2; } shelf{}, highPass{};
+    float truePeakTaps[truePeakFactor][tapsPerPhase] = {};
+    std::vector<Group> groups;
+    std::vector<double> subBlockEnergy; // Sum of K-weighted squares this sub-block
+    int subBlockLength = 4800;
+    int subBlockPosition = 0;
+    std::array<double, subBlocksPerShortTerm> subBlockPowers{}; // Weighted mean squares, ring
+    juce::int64 numSubBlocks = 0;
+    std::array<juce::uint64, numBins> gatedCounts{};
+    std::array<double, numBins> gatedEnergies{};
+
+    std::atomic<float> momentary{ -std::numeric_limits<float>::infinity() };
+    std::atomic<float> shortTerm{ -std::numeric_limits<float>::infinity() };
+    std::atomic<float> integrated{ -std::numeric_limits<float>::infinity() };
+    std::atomic<float> truePeak{ -std::numeric_limits<float>::infinity() };
+    std::atomic<bool> resetRequested{ false };
+
+    juce::SharedResourcePointer<Worker> worker;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
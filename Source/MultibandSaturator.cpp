@@ -0,0 +1,375 @@
+#include "MultibandSaturator.h"
+
+namespace
+{
+    enum class Mode
+    {
+        identity,
+        lowPass,  // Butterworth, two in a row make an LR4 low-pass
+        highPass,
+        allPass   // LR4 low + high sum, which is this single second-order allpass
+    };
+
+    struct Section
+    {
+        Mode mode = Mode::identity;
+        int crossover = 0;
+    };
+
+    // Each band as a cascade applied to the input. Splits form a tree; every band also gets the
+    // allpass of each crossover it didn't go through, so all bands share the same phase and sum flat.
+    constexpr Section twoBands[2][2] =
+    {
+        { { Mode::lowPass, 0 },  { Mode::lowPass, 0 } },
+        { { Mode::highPass, 0 }, { Mode::highPass, 0 } }
+    };
+
+    constexpr Section threeBands[3][4] =
+    {
+        { { Mode::lowPass, 0 },  { Mode::lowPass, 0 },  { Mode::allPass, 1 }, { Mode::identity, 0 } },
+        { { Mode::highPass, 0 }, { Mode::highPass, 0 }, { Mode::lowPass, 1 }, { Mode::lowPass, 1 } },
+        { { Mode::highPass, 0 }, { Mode::highPass, 0 }, { Mode::highPass, 1 }, { Mode::highPass, 1 } }
+    };
+
+    // Split at the middle crossover first, then each half at its own
+    constexpr Section fourBands[4][5] =
+    {
+        { { Mode::lowPass, 1 },  { Mode::lowPass, 1 },  { Mode::lowPass, 0 },  { Mode::lowPass, 0 },  { Mode::allPass, 2 } },
+        { { Mode::lowPass, 1 },  { Mode::lowPass, 1 },  { Mode::highPass, 0 }, { Mode::highPass, 0 }, { Mode::allPass, 2 } },
+        { { Mode::highPass, 1 }, { Mode::highPass, 1 }, { Mode::lowPass, 2 },  { Mode::lowPass, 2 },  { Mode::allPass, 0 } },
+        { { Mode::highPass, 1 }, { Mode::highPass, 1 }, { Mode::highPass, 2 }, { Mode::highPass, 2 }, { Mode::allPass, 0 } }
+    };
+
+    Section getSection(int numBands, int band, int section) noexcept
+    {
+        switch (numBands)
+        {
+            case 2:  return twoBands[band][section];
+            case 3:  return threeBands[band][section];
+            case 4:  return fourBands[band][section];
+            default: return {};
+        }
+    }
+
+    int getNumSections(int numBands) noexcept
+    {
+        switch (numBands)
+        {
+            case 2:  return 2;
+            case 3:  return 4;
+            case 4:  return 5;
+            default: return 0;
+        }
+    }
+
+    const float* getCrossovers(int numBands) noexcept
+    {
+        switch (numBands)
+        {
+            case 2:  return MultibandSaturator::crossovers2;
+            case 3:  return MultibandSaturator::crossovers3;
+            default: return MultibandSaturator::crossovers4;
+        }
+    }
+
+    struct SectionCoefficients
+    {
+        SimdFloat a1, a2, a3, mixInput, mixBand, mixLow;
+    };
+
+    // Trapezoidal SVF step with a per-lane output mix: y = mixInput * x + mixBand * band + mixLow * low
+    inline SimdFloat tick(SimdFloat v0, SimdFloat& s1, SimdFloat& s2, const SectionCoefficients& c) noexcept
+    {
+        const auto two = SimdFloat::broadcast(2.0f);
+        const auto v3 = v0 - s2;
+        const auto v1 = c.a1 * s1 + c.a2 * v3;
+        const auto v2 = s2 + c.a2 * s1 + c.a3 * v3;
+        s1 = two * v1 - s1;
+        s2 = two * v2 - s2;
+        return c.mixInput * v0 + c.mixBand * v1 + c.mixLow * v2;
+    }
+}
+
+//==============================================================================
+void MultibandSaturator::prepare(double newSampleRate, int numChannels)
+{
+    numChannelsPrepared = juce::jmax(0, numChannels);
+
+    // Sized for the most bands, so changing the band count never allocates
+    const int maxLanes = ((numChannelsPrepared * maxBands + SimdFloat::size - 1) / SimdFloat::size) * SimdFloat::size;
+    const auto size = (size_t)(maxSections * maxLanes);
+
+    for (auto* v : { &a1, &a2, &a3, &mixInput, &mixBand, &mixLow, &ic1eq, &ic2eq })
+        v->assign(size, 0.0f);
+
+    inputCopy.assign((size_t)(numChannelsPrepared * tileLength), 0.0f);
+
+    sampleRate = newSampleRate;
+    updateCoefficients();
+}
+
+void MultibandSaturator::reset()
+{
+    std::fill(ic1eq.begin(), ic1eq.end(), 0.0f);
+    std::fill(ic2eq.begin(), ic2eq.end(), 0.0f);
+}
+
+bool MultibandSaturator::isQuiet(float threshold) const noexcept
+{
+    const auto used = (size_t)(numSections * numLanes);
+
+    for (size_t i = 0; i < used; ++i)
+        if (std::abs(ic1eq[i]) > threshold || std::abs(ic2eq[i]) > threshold)
+            return false;
+
+    return true;
+}
+
+double MultibandSaturator::getTailSeconds() const noexcept
+{
+    return tailSeconds.load(std::memory_order_relaxed);
+}
+
+void MultibandSaturator::setSampleRate(double newSampleRate)
+{
+    if (newSampleRate == sampleRate)
+        return;
+
+    sampleRate = newSampleRate;
+    updateCoefficients();
+    reset();
+}
+
+void MultibandSaturator::setNumBands(int newNumBands)
+{
+    newNumBands = juce::jlimit(1, maxBands, newNumBands);
+
+    if (newNumBands == numBands)
+        return;
+
+    numBands = newNumBands;
+    updateCoefficients();
+    reset();
+}
+
+void MultibandSaturator::updateCoefficients()
+{
+    numSections = getNumSections(numBands);
+    numLanes = ((numChannelsPrepared * numBands + SimdFloat::size - 1) / SimdFloat::size) * SimdFloat::size;
+
+    // Butterworth sections (Q = 1 / sqrt 2) at the lowest crossover ring longest. The whole cascade
+    // rings about as long as that one section does; allow twice that for the rest.
+    // Kept in an atomic because hosts ask for the tail from their own thread.
+    const double slowestSection = std::log(1.0e6) * juce::MathConstants<double>::sqrt2 * 0.5
+                                / (juce::MathConstants<double>::pi * getCrossovers(numBands)[0]);
+    tailSeconds.store(numSections == 0 ? 0.0 : 2.0 * slowestSection, std::memory_order_relaxed);
+
+    if (numSections == 0 || (size_t)(numSections * numLanes) > a1.size())
+        return;
+
+    const float* crossovers = getCrossovers(numBands);
+    const double k = juce::MathConstants<double>::sqrt2; // Butterworth
+
+    for (int section = 0; section < numSections; ++section)
+    {
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const auto index = (size_t)(section * numLanes + lane);
+            const bool isPadding = lane >= numChannelsPrepared * numBands;
+            const auto spec = isPadding ? Section{} : getSection(numBands, lane % numBands, section);
+
+            // Identity sections run with g = 0, which leaves their state at zero
+            const double frequency = juce::jmin((double)crossovers[spec.crossover], 0.49 * sampleRate);
+            const double g = spec.mode == Mode::identity ? 0.0 : std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+
+            a1[index] = (float)(1.0 / (1.0 + g * (g + k)));
+            a2[index] = (float)(g * a1[index]);
+            a3[index] = (float)(g * a2[index]);
+
+            // high = x - k * band - low, so every mode is a mix of input, band and low
+            switch (spec.mode)
+            {
+                case Mode::lowPass:  mixInput[index] = 0.0f; mixBand[index] = 0.0f;              mixLow[index] = 1.0f;  break;
+                case Mode::highPass: mixInput[index] = 1.0f; mixBand[index] = (float)-k;         mixLow[index] = -1.0f; break;
+                case Mode::allPass:  mixInput[index] = 1.0f; mixBand[index] = (float)(-2.0 * k); mixLow[index] = 0.0f;  break;
+                case Mode::identity:
+                default:             mixInput[index] = 1.0f; mixBand[index] = 0.0f;              mixLow[index] = 0.0f;  break;
+            }
+        }
+    }
+}
+
+//==============================================================================
+void MultibandSaturator::process(juce::dsp::AudioBlock<float> block, float startGain, float endGain,
+                                 const float* bandDrives, SaturationKernel::Curve curve) noexcept
+{
+    using namespace SaturationKernel;
+
+    if (numSections == 0)
+        return;
+
+    switch (curve)
+    {
+        case Curve::tanh:     processWith<Tanh>(block, startGain, endGain, bandDrives); break;
+        case Curve::tube:     processWith<Tube>(block, startGain, endGain, bandDrives); break;
+        case Curve::hardClip: processWith<HardClip>(block, startGain, endGain, bandDrives); break;
+        case Curve::softKnee:
+        case Curve::numCurves:
+        default:              processWith<SoftKnee>(block, startGain, endGain, bandDrives); break;
+    }
+}
+
+template <typename Shape>
+void MultibandSaturator::processWith(juce::dsp::AudioBlock<float> block, float startGain, float endGain, const float* bandDrives) noexcept
+{
+    // Steady gain keeps the drive in a register; only a moving one pays for the per-sample add
+    if (startGain == endGain)
+        processTiles<Shape, false>(block, startGain, endGain, bandDrives);
+    else
+        processTiles<Shape, true>(block, startGain, endGain, bandDrives);
+}
+
+template <typename Shape, bool ramping>
+void MultibandSaturator::processTiles(juce::dsp::AudioBlock<float> block, float startGain, float endGain, const float* bandDrives) noexcept
+{
+    const int numChannels = juce::jmin((int)block.getNumChannels(), numChannelsPrepared);
+    const int numSamples = (int)block.getNumSamples();
+    const int usedLanes = numChannels * numBands;
+    const float gainStep = ramping ? (endGain - startGain) / (float)numSamples : 0.0f;
+
+    alignas(64) float tile[tileLength][SimdFloat::size];
+
+    for (int tileStart = 0; tileStart < numSamples; tileStart += tileLength)
+    {
+        const int tileSamples = juce::jmin(tileLength, numSamples - tileStart);
+
+        // Keep this stretch of input, then sum the bands back into the buffer in its place
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = block.getChannelPointer((size_t)channel) + tileStart;
+            std::copy(data, data + tileSamples, inputCopy.data() + channel * tileLength);
+            std::fill(data, data + tileSamples, 0.0f);
+        }
+
+        for (int firstLane = 0; firstLane < usedLanes; firstLane += SimdFloat::size)
+        {
+            const int lanesInGroup = juce::jmin(SimdFloat::size, usedLanes - firstLane);
+
+            // Every band lane of a channel starts from that channel's input
+            for (int i = 0; i < tileSamples; ++i)
+            {
+                for (int lane = 0; lane < SimdFloat::size; ++lane)
+                    tile[i][lane] = lane < lanesInGroup ? inputCopy[(size_t)((firstLane + lane) / numBands * tileLength + i)] : 0.0f;
+            }
+
+            // With a ramp, the drive starts one step before this tile's first sample and steps before each multiply
+            const float tileGain = ramping ? startGain + (float)tileStart * gainStep : endGain;
+            alignas(64) float drives[SimdFloat::size] = {};
+            alignas(64) float driveSteps[SimdFloat::size] = {};
+
+            for (int lane = 0; lane < lanesInGroup; ++lane)
+            {
+                drives[lane] = tileGain * bandDrives[(firstLane + lane) % numBands];
+                driveSteps[lane] = gainStep * bandDrives[(firstLane + lane) % numBands];
+            }
+
+            auto drive = SimdFloat::load(drives);
+            const auto driveStep = SimdFloat::load(driveSteps);
+
+            // Same rule as SaturationKernel: the curve only applies where the drive is above 1. Each lane's
+            // drive is monotonic over the tile, so its two ends say whether all, none or some of it saturates.
+            bool anySaturates = false, allSaturate = true;
+
+            for (int lane = 0; lane < lanesInGroup; ++lane)
+            {
+                const float first = drives[lane] + driveSteps[lane];
+                const float last = drives[lane] + driveSteps[lane] * (float)tileSamples;
+                anySaturates = anySaturates || first > 1.0f || last > 1.0f;
+                allSaturate = allSaturate && first > 1.0f && last > 1.0f;
+            }
+
+            SectionCoefficients coefficients[maxSections];
+            SimdFloat s1[maxSections], s2[maxSections];
+
+            for (int section = 0; section < numSections; ++section)
+            {
+                const auto offset = (size_t)(section * numLanes + firstLane);
+                coefficients[section] = { SimdFloat::load(a1.data() + offset), SimdFloat::load(a2.data() + offset),
+                                          SimdFloat::load(a3.data() + offset), SimdFloat::load(mixInput.data() + offset),
+                                          SimdFloat::load(mixBand.data() + offset), SimdFloat::load(mixLow.data() + offset) };
+                s1[section] = SimdFloat::load(ic1eq.data() + offset);
+                s2[section] = SimdFloat::load(ic2eq.data() + offset);
+            }
+
+            auto filterAndDrive = [&](int i)
+            {
+                auto x = SimdFloat::load(tile[i]);
+
+                for (int section = 0; section < numSections; ++section)
+                    x = tick(x, s1[section], s2[section], coefficients[section]);
+
+                if constexpr (ramping)
+                    drive = drive + driveStep;
+
+                return x * drive;
+            };
+
+            if (allSaturate)
+            {
+                for (int i = 0; i < tileSamples; ++i)
+                {
+                    const auto x = filterAndDrive(i);
+
+                    if constexpr (Shape::isVectorised)
+                    {
+                        Shape::processVector(x).store(tile[i]);
+                    }
+                    else
+                    {
+                        x.store(tile[i]);
+
+                        for (int lane = 0; lane < lanesInGroup; ++lane)
+                            tile[i][lane] = Shape::processSample(tile[i][lane]);
+                    }
+                }
+            }
+            else if (! anySaturates)
+            {
+                for (int i = 0; i < tileSamples; ++i)
+                    filterAndDrive(i).store(tile[i]);
+            }
+            else
+            {
+                // Some lanes above 1 and some not (a quiet gain with a driven band, or a ramp crossing 1):
+                // the curve goes lane by lane, on the drive each sample actually got
+                alignas(64) float laneDrives[SimdFloat::size];
+
+                for (int i = 0; i < tileSamples; ++i)
+                {
+                    filterAndDrive(i).store(tile[i]);
+                    drive.store(laneDrives);
+
+                    for (int lane = 0; lane < lanesInGroup; ++lane)
+                        if (laneDrives[lane] > 1.0f)
+                            tile[i][lane] = Shape::processSample(tile[i][lane]);
+                }
+            }
+
+            for (int section = 0; section < numSections; ++section)
+            {
+                const auto offset = (size_t)(section * numLanes + firstLane);
+                s1[section].store(ic1eq.data() + offset);
+                s2[section].store(ic2eq.data() + offset);
+            }
+
+            // Sum the band lanes back into their channels
+            for (int lane = 0; lane < lanesInGroup; ++lane)
+            {
+                auto* data = block.getChannelPointer((size_t)((firstLane + lane) / numBands)) + tileStart;
+
+                for (int i = 0; i < tileSamples; ++i)
+                    data[i] += tile[i][lane];
+            }
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SaturationKernel.h"
+
+// Multiband mode of the Harmonic Boost: splits each channel into 2-4 bands with
+// Linkwitz-Riley (LR4) crossovers, drives and saturates every band on its own, then sums
+// them back. The bands are phase-coherent: with no drive the sum is an allpass.
+//
+// Each band is written as the same-length cascade of SVF sections applied to the input
+// (low/high-pass halves of its crossovers plus allpass compensation for the others), so
+// every (channel, band) pair is one SIMD lane and all of them run through one vectorised
+// cascade with per-lane coefficients. Stereo in four bands fills a single AVX register.
+// Everything is allocated in prepare(); the other calls never allocate.
+class MultibandSaturator
+{
+public:
+    static constexpr int maxBands = 4;
+
+    MultibandSaturator() = default;
+
+    void prepare(double sampleRate, int numChannels);
+    void reset(); // Clears the filter state
+    bool isQuiet(float threshold) const noexcept; // Every section's state is below threshold
+    double getTailSeconds() const noexcept;       // 120 dB decay of the cascade, 0 when bypassed; any thread
+
+    void setSampleRate(double newSampleRate); // Follows the oversampling factor, recomputes the crossovers
+    void setNumBands(int newNumBands);        // 1 means bypassed; resets the state when it changes
+    int getNumBands() const noexcept { return numBands; }
+
+    // Band i gets gain * bandDrives[i] before the curve, which applies where that drive is above 1,
+    // the same rule as SaturationKernel::process. The gain ramps linearly from startGain to endGain
+    // over the block, as in SaturationKernel.
+    void process(juce::dsp::AudioBlock<float> block, float startGain, float endGain,
+                 const float* bandDrives, SaturationKernel::Curve curve) noexcept;
+
+    // Crossover frequencies for each band count
+    static constexpr float crossovers2[] = { 800.0f };
+    static constexpr float crossovers3[] = { 250.0f, 2500.0f };
+    static constexpr float crossovers4[] = { 150.0f, 800.0f, 4000.0f };
+
+private:
+    template <typename Shape>
+    void processWith(juce::dsp::AudioBlock<float> block, float startGain, float endGain, const float* bandDrives) noexcept;
+
+    template <typename Shape, bool ramping>
+    void processTiles(juce::dsp::AudioBlock<float> block, float startGain, float endGain, const float* bandDrives) noexcept;
+
+    void updateCoefficients();
+
+    static constexpr int maxSections = 5; // Longest band cascade, for four bands
+    static constexpr int tileLength = 64;
+
+    double sampleRate = 44100.0;
+    int numChannelsPrepared = 0;
+    int numBands = 1;
+    int numSections = 0;
+    int numLanes = 0;       // numChannelsPrepared * numBands, padded to whole vectors
+    std::atomic<double> tailSeconds{ 0.0 };
+
+    // Per section, per lane (section-major): SVF coefficients, output mix and state
+    std::vector<float> a1, a2, a3, mixInput, mixBand, mixLow;
+    std::vector<float> ic1eq, ic2eq;
+
+    std::vector<float> inputCopy; // One tile of every channel's input, kept while the outputs are summed in place
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultibandSaturator)
+};
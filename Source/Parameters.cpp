@@ -0,0 +1,38 @@
+#include "Parameters.h"
+
+juce::AudioProcessorValueTreeState::ParameterLayout Parameters::createLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    for (auto& spec : specs)
+    {
+        if (spec.isChoice())
+        {
+            juce::StringArray choices;
+            for (int i = 0; i < spec.numChoices; ++i)
+                choices.add(spec.choices[i]);
+
+            layout.add(std::make_unique<juce::AudioParameterChoice>(spec.paramID, spec.name, choices, (int)spec.defaultValue));
+        }
+        else if (spec.isToggle)
+        {
+            layout.add(std::make_unique<juce::AudioParameterBool>(spec.paramID, spec.name, spec.defaultValue >= 0.5f));
+        }
+        else
+        {
+            const juce::NormalisableRange<float> range(spec.minimum, spec.maximum, spec.interval);
+            layout.add(std::make_unique<juce::AudioParameterFloat>(spec.paramID, spec.name, range, spec.defaultValue));
+        }
+    }
+
+    return layout;
+}
+
+Parameters::Handles::Handles(juce::AudioProcessorValueTreeState& state)
+{
+    for (auto& spec : specs)
+    {
+        values[(size_t)spec.id] = state.getRawParameterValue(spec.paramID);
+        jassert(values[(size_t)spec.id] != nullptr); // The layout must have come from createLayout()
+    }
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "MultibandSaturator.h"
+
+// Every parameter the processor exposes, in one constexpr table. The layout given to
+// the AudioProcessorValueTreeState is built from it, and the audio thread reads values
+// through atomic pointers cached once at construction, never by string lookup.
+// To add a parameter: add an ID, a row in specs and a field in Snapshot.
+namespace Parameters
+{
+    enum class ID
+    {
+        gain,
+        eqBoost,
+        oversampling,
+        oversamplingFilter,
+        saturationCurve,
+        bands,
+        band1Drive,
+        band2Drive,
+        band3Drive,
+        band4Drive,
+        autoGain,
+        limiter,
+        limiterLookahead,
+        numParameters
+    };
+
+    constexpr int numParameters = (int)ID::numParameters;
+
+    struct Spec
+    {
+        ID id;
+        const char* paramID;
+        const char* name;
+        float minimum;
+        float maximum;
+        float defaultValue;                  // Index for choice parameters, 0 or 1 for toggles
+        const char* const* choices = nullptr;
+        int numChoices = 0;
+        bool isToggle = false;               // On/off, an AudioParameterBool
+        float interval = 0.0f;               // Step of a continuous parameter, 0 for none
+
+        constexpr bool isChoice() const noexcept { return numChoices > 0; }
+        constexpr bool isStepped() const noexcept { return isChoice() || isToggle; }
+    };
+
+    inline constexpr const char* oversamplingChoices[] = { "1x", "2x", "4x", "8x" };
+    inline constexpr const char* oversamplingFilterChoices[] = { "IIR", "FIR" }; // Polyphase IIR (low latency) or linear-phase FIR (clean)
+    inline constexpr const char* saturationCurveChoices[] = { "Soft", "Tanh", "Tube", "Clip" }; // In SaturationKernel::Curve order
+    inline constexpr const char* bandsChoices[] = { "1", "2", "3", "4" }; // Index + 1 bands, see MultibandSaturator
+
+    inline constexpr Spec specs[] =
+    {
+        { ID::gain,               "gain",               "Gain",                0.0f, 10.0f, 1.0f },
+        { ID::eqBoost,            "eqBoost",            "EQ Boost",            0.0f, 10.0f, 0.0f },
+        { ID::oversampling,       "oversampling",       "Oversampling",        0.0f, 3.0f,  0.0f, oversamplingChoices, 4 },
+        { ID::oversamplingFilter, "oversamplingFilter", "Oversampling Filter", 0.0f, 1.0f,  0.0f, oversamplingFilterChoices, 2 },
+        { ID::saturationCurve,    "saturationCurve",    "Saturation Curve",    0.0f, 3.0f,  0.0f, saturationCurveChoices, 4 },
+        { ID::bands,              "bands",              "Bands",               0.0f, 3.0f,  0.0f, bandsChoices, 4 },
+        { ID::band1Drive,         "band1Drive",         "Band 1 Drive",        0.0f, 24.0f, 0.0f }, // Extra drive in dB on top of the gain
+        { ID::band2Drive,         "band2Drive",         "Band 2 Drive",        0.0f, 24.0f, 0.0f },
+        { ID::band3Drive,         "band3Drive",         "Band 3 Drive",        0.0f, 24.0f, 0.0f },
+        { ID::band4Drive,         "band4Drive",         "Band 4 Drive",        0.0f, 24.0f, 0.0f },
+        { ID::autoGain,           "autoGain",           "Auto Gain",           0.0f, 1.0f,  0.0f, nullptr, 0, true }, // Makeup to match the input level
+        { ID::limiter,            "limiter",            "Limiter",             0.0f, 1.0f,  0.0f, nullptr, 0, true }, // 0 dBFS lookahead limiter at the output
+        { ID::limiterLookahead,   "limiterLookahead",   "Limiter Lookahead",   0.5f, 10.0f, 1.5f, nullptr, 0, false, 0.5f } // Milliseconds, added to the latency
+    };
+
+    constexpr const Spec& getSpec(ID id) noexcept { return specs[(size_t)id]; }
+    constexpr const char* getParamID(ID id) noexcept { return getSpec(id).paramID; }
+
+    //==============================================================================
+    // Compile-time checks on the table
+    namespace detail
+    {
+        constexpr bool stringsEqual(const char* a, const char* b) noexcept
+        {
+            while (*a != 0 && *a == *b)
+            {
+                ++a;
+                ++b;
+            }
+
+            return *a == *b;
+        }
+
+        constexpr bool rowsMatchIDs() noexcept
+        {
+            for (int i = 0; i < numParameters; ++i)
+                if ((int)specs[i].id != i)
+                    return false;
+
+            return true;
+        }
+
+        constexpr bool paramIDsAreUnique() noexcept
+        {
+            for (int i = 0; i < numParameters; ++i)
+                for (int j = i + 1; j < numParameters; ++j)
+                    if (stringsEqual(specs[i].paramID, specs[j].paramID))
+                        return false;
+
+            return true;
+        }
+
+        constexpr bool rangesAreValid() noexcept
+        {
+            for (auto& spec : specs)
+                if (! (spec.minimum < spec.maximum) || spec.defaultValue < spec.minimum || spec.defaultValue > spec.maximum)
+                    return false;
+
+            return true;
+        }
+
+        constexpr bool choicesAreValid() noexcept
+        {
+            for (auto& spec : specs)
+                if (spec.isChoice() && (spec.choices == nullptr
+                                        || spec.minimum != 0.0f
+                                        || spec.maximum != (float)(spec.numChoices - 1)
+                                        || spec.defaultValue != (float)(int)spec.defaultValue))
+                    return false;
+
+            return true;
+        }
+
+        // "band<N>Drive", for band N - 1, or for any band when band is negative
+        constexpr bool isBandDrive(const char* paramID, int band) noexcept
+        {
+            const char prefix[] = "band";
+            for (int i = 0; i < 4; ++i)
+                if (paramID[i] != prefix[i])
+                    return false;
+
+            const char digit = paramID[4];
+            if (band >= 0 ? digit != (char)('1' + band) : (digit < '1' || digit > '9'))
+                return false;
+
+            return stringsEqual(paramID + 5, "Drive");
+        }
+
+        constexpr int countBandDrives() noexcept
+        {
+            int count = 0;
+            for (auto& spec : specs)
+                if (isBandDrive(spec.paramID, -1))
+                    ++count;
+
+            return count;
+        }
+
+        constexpr bool bandDrivesFollowBand1() noexcept
+        {
+            for (int band = 0; band < countBandDrives(); ++band)
+            {
+                const int index = (int)ID::band1Drive + band;
+                if (index >= numParameters || ! isBandDrive(specs[index].paramID, band))
+                    return false;
+            }
+
+            return true;
+        }
+
+        constexpr bool intervalsAreValid() noexcept
+        {
+            auto onGrid = [](float distance, float interval) { return distance / interval == (float)(int)(distance / interval); };
+
+            for (auto& spec : specs)
+                if (spec.interval < 0.0f || (spec.interval > 0.0f && (spec.isStepped()
+                                                                      || ! onGrid(spec.maximum - spec.minimum, spec.interval)
+                                                                      || ! onGrid(spec.defaultValue - spec.minimum, spec.interval))))
+                    return false;
+
+            return true;
+        }
+
+        constexpr bool togglesAreValid() noexcept
+        {
+            for (auto& spec : specs)
+                if (spec.isToggle && (spec.isChoice()
+                                      || spec.minimum != 0.0f
+                                      || spec.maximum != 1.0f
+                                      || (spec.defaultValue != 0.0f && spec.defaultValue != 1.0f)))
+                    return false;
+
+            return true;
+        }
+    }
+
+    static_assert(sizeof(specs) / sizeof(specs[0]) == numParameters, "Every ID needs exactly one row in specs");
+    static_assert(detail::rowsMatchIDs(), "Rows in specs must be in the same order as ID");
+    static_assert(detail::paramIDsAreUnique(), "Parameter IDs must be unique");
+    static_assert(detail::rangesAreValid(), "Each range must be non-empty and contain its default");
+    static_assert(detail::choicesAreValid(), "Choice parameters must span 0 to numChoices - 1 with an integer default");
+    static_assert(detail::togglesAreValid(), "Toggles have no choices, span 0 to 1 and default to 0 or 1");
+    static_assert(detail::intervalsAreValid(), "Intervals are for continuous parameters, with the range and default on the grid");
+    static_assert(detail::countBandDrives() == MultibandSaturator::maxBands, "One bandNDrive parameter per multiband band");
+    static_assert(detail::bandDrivesFollowBand1(), "band1Drive to bandNDrive must be consecutive IDs, in order");
+    static_assert(getSpec(ID::bands).numChoices == MultibandSaturator::maxBands, "One Bands choice per band count");
+
+    //==============================================================================
+    // Every value the DSP needs for one block, read once at the top of processBlock
+    struct Snapshot
+    {
+        float gain = getSpec(ID::gain).defaultValue;
+        float eqBoost = getSpec(ID::eqBoost).defaultValue;
+        int oversampling = 0;
+        int oversamplingFilter = 0;
+        int saturationCurve = 0;
+        int bands = 0;                          // Index, so one band less than the count
+        std::array<float, MultibandSaturator::maxBands> bandDriveDecibels{};
+        bool autoGain = false;
+        bool limiter = false;
+        float limiterLookahead = getSpec(ID::limiterLookahead).defaultValue;
+    };
+
+    juce::AudioProcessorValueTreeState::ParameterLayout createLayout();
+
+    // Cached pointers to the value tree's atomics, one per ID
+    class Handles
+    {
+    public:
+        explicit Handles(juce::AudioProcessorValueTreeState& state);
+
+        // Float for continuous parameters, a clamped index for choices, bool for toggles
+        template <ID id>
+        auto get() const noexcept
+        {
+            constexpr const Spec& spec = getSpec(id);
+            const float value = values[(size_t)id]->load(std::memory_order_relaxed);
+
+            if constexpr (spec.isToggle)
+                return value >= 0.5f;
+            else if constexpr (spec.isChoice())
+                return juce::jlimit(0, spec.numChoices - 1, (int)value);
+            else
+                return value;
+        }
+
+        Snapshot snapshot() const noexcept
+        {
+            Snapshot s;
+            s.gain = get<ID::gain>();
+            s.eqBoost = get<ID::eqBoost>();
+            s.oversampling = get<ID::oversampling>();
+            s.oversamplingFilter = get<ID::oversamplingFilter>();
+            s.saturationCurve = get<ID::saturationCurve>();
+            s.bands = get<ID::bands>();
+
+            for (size_t band = 0; band < s.bandDriveDecibels.size(); ++band) // Consecutive IDs, checked above
+                s.bandDriveDecibels[band] = values[(size_t)ID::band1Drive + band]->load(std::memory_order_relaxed);
+
+            s.autoGain = get<ID::autoGain>();
+            s.limiter = get<ID::limiter>();
+            s.limiterLookahead = get<ID::limiterLookahead>();
+            return s;
+        }
+
+    private:
+        std::array<std::atomic<float>*, numParameters> values{};
+
+        JUCE_DECLARE_NON_COPYABLE(Handles)
+    };
+}
@@ -0,0 +1,442 @@
+#include "PeakFilter.h"
+
+namespace
+{
+    struct VectorCoefficients
+    {
+        SimdFloat a1, a2, a3, m1;
+    };
+
+    // One trapezoidal SVF step for every lane
+    inline SimdFloat tick(SimdFloat v0, SimdFloat& s1, SimdFloat& s2, const VectorCoefficients& c) noexcept
+    {
+        const auto two = SimdFloat::broadcast(2.0f);
+        const auto v3 = v0 - s2;
+        const auto v1 = c.a1 * s1 + c.a2 * v3;
+        const auto v2 = s2 + c.a2 * s1 + c.a3 * v3;
+        s1 = two * v1 - s1;
+        s2 = two * v2 - s2;
+        return v0 + c.m1 * v1;
+    }
+
+    // Planar channel data <-> one sample of every channel in the group, one per lane
+    inline SimdFloat gather(float* const* channels, int numLanes, int index) noexcept
+    {
+        alignas(64) float lanes[SimdFloat::size] = {};
+        for (int lane = 0; lane < numLanes; ++lane)
+            lanes[lane] = channels[lane][index];
+
+        return SimdFloat::load(lanes);
+    }
+
+    inline void scatter(SimdFloat value, float* const* channels, int numLanes, int index) noexcept
+    {
+        alignas(64) float lanes[SimdFloat::size];
+        value.store(lanes);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            channels[lane][index] = lanes[lane];
+    }
+
+    //==============================================================================
+    // What happens to each filtered vector before it is written back
+    struct FilterOnly
+    {
+        static constexpr bool meters = false;
+
+        SimdFloat apply(SimdFloat y) const noexcept { return y; }
+    };
+
+    template <typename Shape, bool saturate, bool meter>
+    struct FusedStage
+    {
+        static constexpr bool meters = meter;
+
+        SimdFloat gain;
+
+        SimdFloat apply(SimdFloat y) const noexcept
+        {
+            y = y * gain;
+
+            if constexpr (! saturate)
+            {
+                return y;
+            }
+            else if constexpr (Shape::isVectorised)
+            {
+                return Shape::processVector(y);
+            }
+            else
+            {
+                // Tabulated curves are read one lane at a time
+                alignas(64) float lanes[SimdFloat::size];
+                y.store(lanes);
+
+                for (auto& lane : lanes)
+                    lane = Shape::processSample(lane);
+
+                return SimdFloat::load(lanes);
+            }
+        }
+    };
+}
+
+void PeakFilter::prepare(double sampleRate, int numChannels, float initialGainDecibels)
+{
+    g = (float)std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+
+    amplitude.reset(sampleRate, rampSeconds);
+    amplitude.setCurrentAndTargetValue(std::pow(10.0f, initialGainDecibels / 40.0f));
+    setCoefficients(makeCoefficients(amplitude.getCurrentValue()));
+
+    numChannelsPrepared = juce::jmax(0, numChannels);
+    const auto numGroups = (numChannelsPrepared + SimdFloat::size - 1) / SimdFloat::size;
+    ic1eq.assign((size_t)(numGroups * SimdFloat::size), 0.0f);
+    ic2eq.assign((size_t)(numGroups * SimdFloat::size), 0.0f);
+    peakLanes.assign((size_t)(numGroups * SimdFloat::size), 0.0f);
+    sumSquareLanes.assign((size_t)(numGroups * SimdFloat::size), 0.0f);
+}
+
+void PeakFilter::reset()
+{
+    std::fill(ic1eq.begin(), ic1eq.end(), 0.0f);
+    std::fill(ic2eq.begin(), ic2eq.end(), 0.0f);
+}
+
+bool PeakFilter::isQuiet(float threshold) const noexcept
+{
+    for (size_t i = 0; i < ic1eq.size(); ++i)
+        if (std::abs(ic1eq[i]) > threshold || std::abs(ic2eq[i]) > threshold)
+            return false;
+
+    return true;
+}
+
+double PeakFilter::getTailSeconds(float gainDecibels) noexcept
+{
+    // The envelope of a second-order ring falls as exp(-pi * f * t / Q)
+    const double poleQ = q * std::pow(10.0, gainDecibels / 40.0);
+    return std::log(1.0e6) * poleQ / (juce::MathConstants<double>::pi * frequency);
+}
+
+void PeakFilter::setGainDecibels(float newGainDecibels)
+{
+    amplitude.setTargetValue(std::pow(10.0f, newGainDecibels / 40.0f));
+}
+
+PeakFilter::Coefficients PeakFilter::makeCoefficients(float a) const noexcept
+{
+    Coefficients c;
+    const float k = 1.0f / (q * a);
+    c.a1 = 1.0f / (1.0f + g * (g + k));
+    c.a2 = g * c.a1;
+    c.a3 = g * c.a2;
+    c.m1 = k * (a * a - 1.0f);
+    return c;
+}
+
+void PeakFilter::setCoefficients(const Coefficients& newCoefficients) noexcept
+{
+    coefficients = newCoefficients;
+    blockCoefficients = makeBlockCoefficients(newCoefficients);
+}
+
+PeakFilter::BlockCoefficients PeakFilter::makeBlockCoefficients(const Coefficients& c) noexcept
+{
+    // One tick() written as a linear map of the state and input (in double, rounded once at the end)
+    const double a[2][2] = { { 2.0 * c.a1 - 1.0, -2.0 * c.a2 }, { 2.0 * c.a2, 1.0 - 2.0 * c.a3 } };
+    const double b[2] = { 2.0 * c.a2, 2.0 * c.a3 };
+    const double cRow[2] = { (double)c.m1 * c.a1, -(double)c.m1 * c.a2 };
+    const double d = 1.0 + (double)c.m1 * c.a2;
+
+    auto multiply = [](const double (&m)[2][2], const double (&v)[2], double (&result)[2])
+        {
+            const double r0 = m[0][0] * v[0] + m[0][1] * v[1];
+            const double r1 = m[1][0] * v[0] + m[1][1] * v[1];
+            result[0] = r0;
+            result[1] = r1;
+        };
+
+    BlockCoefficients block;
+
+    // C A^k: the output's view of the state k samples on
+    double row[2] = { cRow[0], cRow[1] };
+    for (int k = 0; k < samplesPerStep; ++k)
+    {
+        block.stateToOutput[k][0] = (float)row[0];
+        block.stateToOutput[k][1] = (float)row[1];
+
+        const double next[2] = { row[0] * a[0][0] + row[1] * a[1][0], row[0] * a[0][1] + row[1] * a[1][1] };
+        row[0] = next[0];
+        row[1] = next[1];
+    }
+
+    // A^m B for m = 0..N-1, then the input terms of the outputs and of the next state
+    double powerTimesB[samplesPerStep][2];
+    powerTimesB[0][0] = b[0];
+    powerTimesB[0][1] = b[1];
+
+    for (int m = 1; m < samplesPerStep; ++m)
+        multiply(a, powerTimesB[m - 1], powerTimesB[m]);
+
+    for (int k = 0; k < samplesPerStep; ++k)
+    {
+        for (int j = 0; j < k; ++j)
+        {
+            const auto& v = powerTimesB[k - 1 - j];
+            block.inputToOutput[k][j] = (float)(cRow[0] * v[0] + cRow[1] * v[1]);
+        }
+
+        block.inputToOutput[k][k] = (float)d;
+    }
+
+    for (int j = 0; j < samplesPerStep; ++j)
+    {
+        block.inputToState[0][j] = (float)powerTimesB[samplesPerStep - 1 - j][0];
+        block.inputToState[1][j] = (float)powerTimesB[samplesPerStep - 1 - j][1];
+    }
+
+    // A^N, column by column
+    for (int column = 0; column < 2; ++column)
+    {
+        double v[2] = { column == 0 ? 1.0 : 0.0, column == 0 ? 0.0 : 1.0 };
+
+        for (int m = 0; m < samplesPerStep; ++m)
+            multiply(a, v, v);
+
+        block.stateToState[0][column] = (float)v[0];
+        block.stateToState[1][column] = (float)v[1];
+    }
+
+    return block;
+}
+
+template <typename Stage>
+void PeakFilter::run(juce::dsp::AudioBlock<float> block, const Stage& stage) noexcept
+{
+    const int numChannels = juce::jmin((int)block.getNumChannels(), numChannelsPrepared);
+    const int numSamples = (int)block.getNumSamples();
+
+    auto toVector = [](const Coefficients& c)
+        {
+            return VectorCoefficients{ SimdFloat::broadcast(c.a1), SimdFloat::broadcast(c.a2),
+                                       SimdFloat::broadcast(c.a3), SimdFloat::broadcast(c.m1) };
+        };
+
+    auto getGroupChannels = [&](int firstChannel, float** channels)
+        {
+            const int numLanes = juce::jmin(SimdFloat::size, numChannels - firstChannel);
+            for (int lane = 0; lane < numLanes; ++lane)
+                channels[lane] = block.getChannelPointer((size_t)(firstChannel + lane));
+
+            return numLanes;
+        };
+
+    auto accumulate = [](SimdFloat y, SimdFloat& peak, SimdFloat& sumSquares)
+        {
+            peak = SimdFloat::max(peak, SimdFloat::abs(y));
+            sumSquares = sumSquares + y * y;
+        };
+
+    if constexpr (Stage::meters)
+    {
+        std::fill(peakLanes.begin(), peakLanes.end(), 0.0f);
+        std::fill(sumSquareLanes.begin(), sumSquareLanes.end(), 0.0f);
+    }
+
+    if (amplitude.isSmoothing())
+    {
+        // Coefficients move every sample while the gain ramps; the SVF state stays consistent
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto c = toVector(makeCoefficients(amplitude.getNextValue()));
+
+            for (int firstChannel = 0; firstChannel < numChannels; firstChannel += SimdFloat::size)
+            {
+                float* channels[SimdFloat::size];
+                const int numLanes = getGroupChannels(firstChannel, channels);
+
+                auto s1 = SimdFloat::load(ic1eq.data() + firstChannel);
+                auto s2 = SimdFloat::load(ic2eq.data() + firstChannel);
+                const auto y = stage.apply(tick(gather(channels, numLanes, i), s1, s2, c));
+                scatter(y, channels, numLanes, i);
+                s1.store(ic1eq.data() + firstChannel);
+                s2.store(ic2eq.data() + firstChannel);
+
+                if constexpr (Stage::meters)
+                {
+                    auto peak = SimdFloat::load(peakLanes.data() + firstChannel);
+                    auto sumSquares = SimdFloat::load(sumSquareLanes.data() + firstChannel);
+                    accumulate(y, peak, sumSquares);
+                    peak.store(peakLanes.data() + firstChannel);
+                    sumSquares.store(sumSquareLanes.data() + firstChannel);
+                }
+            }
+        }
+
+        setCoefficients(makeCoefficients(amplitude.getCurrentValue()));
+    }
+    else
+    {
+        // Settled: fixed coefficients, each group of channels runs through the block with its state in registers,
+        // samplesPerStep samples per step of the state-space form, then per sample for the remainder
+        const auto c = toVector(coefficients);
+        constexpr int n = samplesPerStep;
+
+        SimdFloat stateToState[2][2], inputToState[2][n], stateToOutput[n][2], inputToOutput[n][n];
+
+        for (int row = 0; row < 2; ++row)
+        {
+            for (int column = 0; column < 2; ++column)
+                stateToState[row][column] = SimdFloat::broadcast(blockCoefficients.stateToState[row][column]);
+
+            for (int j = 0; j < n; ++j)
+                inputToState[row][j] = SimdFloat::broadcast(blockCoefficients.inputToState[row][j]);
+        }
+
+        for (int k = 0; k < n; ++k)
+        {
+            stateToOutput[k][0] = SimdFloat::broadcast(blockCoefficients.stateToOutput[k][0]);
+            stateToOutput[k][1] = SimdFloat::broadcast(blockCoefficients.stateToOutput[k][1]);
+
+            for (int j = 0; j < n; ++j)
+                inputToOutput[k][j] = SimdFloat::broadcast(blockCoefficients.inputToOutput[k][j]);
+        }
+
+        // Channels are interleaved into a stack tile a stretch at a time, so the filter reads and
+        // writes whole vectors; unused lanes stay zero
+        constexpr int tileLength = 64;
+        static_assert(tileLength % n == 0, "Tiles must hold whole steps");
+        alignas(64) float tile[tileLength][SimdFloat::size];
+
+        for (int firstChannel = 0; firstChannel < numChannels; firstChannel += SimdFloat::size)
+        {
+            float* channels[SimdFloat::size];
+            const int numLanes = getGroupChannels(firstChannel, channels);
+
+            auto s1 = SimdFloat::load(ic1eq.data() + firstChannel);
+            auto s2 = SimdFloat::load(ic2eq.data() + firstChannel);
+            auto peak = SimdFloat::broadcast(0.0f);
+            auto sumSquares = SimdFloat::broadcast(0.0f);
+
+            std::fill(&tile[0][0], &tile[0][0] + tileLength * SimdFloat::size, 0.0f);
+
+            for (int tileStart = 0; tileStart < numSamples; tileStart += tileLength)
+            {
+                const int tileSamples = juce::jmin(tileLength, numSamples - tileStart);
+
+                for (int lane = 0; lane < numLanes; ++lane)
+                    for (int i = 0; i < tileSamples; ++i)
+                        tile[i][lane] = channels[lane][tileStart + i];
+
+                auto output = [&](SimdFloat y, int i)
+                    {
+                        y = stage.apply(y);
+                        y.store(tile[i]);
+
+                        if constexpr (Stage::meters)
+                            accumulate(y, peak, sumSquares);
+                    };
+
+                int i = 0;
+
+                for (; i + n <= tileSamples; i += n)
+                {
+                    SimdFloat x[n];
+                    for (int j = 0; j < n; ++j)
+                        x[j] = SimdFloat::load(tile[i + j]);
+
+                    // Outputs only read the state at the start of the step, so none of them waits on another
+                    for (int k = 0; k < n; ++k)
+                    {
+                        auto y = stateToOutput[k][0] * s1 + stateToOutput[k][1] * s2;
+                        for (int j = 0; j <= k; ++j)
+                            y = y + inputToOutput[k][j] * x[j];
+
+                        output(y, i + k);
+                    }
+
+                    auto next1 = stateToState[0][0] * s1 + stateToState[0][1] * s2;
+                    auto next2 = stateToState[1][0] * s1 + stateToState[1][1] * s2;
+
+                    for (int j = 0; j < n; ++j)
+                    {
+                        next1 = next1 + inputToState[0][j] * x[j];
+                        next2 = next2 + inputToState[1][j] * x[j];
+                    }
+
+                    s1 = next1;
+                    s2 = next2;
+                }
+
+                for (; i < tileSamples; ++i)
+                    output(tick(SimdFloat::load(tile[i]), s1, s2, c), i);
+
+                for (int lane = 0; lane < numLanes; ++lane)
+                    for (int j = 0; j < tileSamples; ++j)
+                        channels[lane][tileStart + j] = tile[j][lane];
+            }
+
+            s1.store(ic1eq.data() + firstChannel);
+            s2.store(ic2eq.data() + firstChannel);
+
+            if constexpr (Stage::meters)
+            {
+                peak.store(peakLanes.data() + firstChannel);
+                sumSquares.store(sumSquareLanes.data() + firstChannel);
+            }
+        }
+    }
+}
+
+void PeakFilter::process(juce::dsp::AudioBlock<float> block) noexcept
+{
+    run(block, FilterOnly{});
+}
+
+void PeakFilter::process(juce::dsp::AudioBlock<float> block, const GainStage& stage) noexcept
+{
+    using namespace SaturationKernel;
+
+    const int numChannels = juce::jmin((int)block.getNumChannels(), numChannelsPrepared);
+    const bool meter = stage.peaks != nullptr && stage.meanSquares != nullptr;
+    const auto gain = SimdFloat::broadcast(stage.gain);
+
+    // Every branch is resolved here, once per block, so the sample loop is a single specialisation
+    auto runWith = [&](auto shape)
+        {
+            using Shape = decltype(shape);
+
+            if (stage.gain > 1.0f)
+            {
+                if (meter) run(block, FusedStage<Shape, true, true>{ gain });
+                else       run(block, FusedStage<Shape, true, false>{ gain });
+            }
+            else
+            {
+                if (meter) run(block, FusedStage<Shape, false, true>{ gain });
+                else       run(block, FusedStage<Shape, false, false>{ gain });
+            }
+        };
+
+    switch (stage.curve)
+    {
+        case Curve::tanh:     runWith(Tanh{}); break;
+        case Curve::tube:     runWith(Tube{}); break;
+        case Curve::hardClip: runWith(HardClip{}); break;
+        case Curve::softKnee:
+        case Curve::numCurves:
+        default:              runWith(SoftKnee{}); break;
+    }
+
+    if (meter)
+    {
+        const float scale = block.getNumSamples() > 0 ? 1.0f / (float)block.getNumSamples() : 0.0f;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            stage.peaks[channel] = peakLanes[(size_t)channel];
+            stage.meanSquares[channel] = sumSquareLanes[(size_t)channel] * scale;
+        }
+    }
+}
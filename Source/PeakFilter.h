@@ -0,0 +1,88 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SaturationKernel.h"
+
+// Bell filter for the Harmonic Boost (400 Hz, Q 0.707), built as a topology-preserving
+// transform state variable filter (Simper's trapezoidal SVF). It has the same response
+// as the RBJ peak biquad it replaces, but its state stays valid when the coefficients
+// move, so the gain can be ramped every sample without zipper noise.
+// Everything is allocated in prepare(); setGainDecibels() and process() never allocate.
+//
+// Channels are processed SimdFloat::size at a time, one channel per vector lane, so
+// the recursive part of the filter costs the same for 1 channel as for a full register.
+// Once the gain has settled, the filter also steps samplesPerStep samples at a time
+// through its state-space form, so the feedback chain is one step long per
+// samplesPerStep samples instead of per sample; with few channels that chain is the cost.
+//
+// Without oversampling the rest of the channel strip can ride along: process() with a
+// GainStage applies gain, saturation and peak/RMS metering to each filtered sample while
+// it is still in a register, so the block is read and written once instead of three times.
+class PeakFilter
+{
+public:
+    PeakFilter() = default;
+
+    void prepare(double sampleRate, int numChannels, float initialGainDecibels);
+    void reset(); // Clears the filter state, keeps the gain
+    bool isQuiet(float threshold) const noexcept; // Every channel's state is below threshold, so the output is just the input
+
+    // Time for the ring to decay by 120 dB at this boost (the bell's poles have Q = q * 10^(dB / 40))
+    static double getTailSeconds(float gainDecibels) noexcept;
+
+    void setGainDecibels(float newGainDecibels); // New target, reached over rampSeconds
+    void process(juce::dsp::AudioBlock<float> block) noexcept;
+
+    struct GainStage
+    {
+        float gain = 1.0f;
+        SaturationKernel::Curve curve = SaturationKernel::Curve::softKnee; // Applied when gain > 1, as in SaturationKernel::process
+        float* peaks = nullptr;       // Optional, one per channel: largest |output| in the block
+        float* meanSquares = nullptr; // Optional, one per channel: mean of output^2 (both or neither)
+    };
+
+    // Filter, then gain, saturation and metering, in a single pass over the block
+    void process(juce::dsp::AudioBlock<float> block, const GainStage& stage) noexcept;
+
+    static constexpr float frequency = 400.0f;
+    static constexpr float q = 0.707f;
+    static constexpr double rampSeconds = 0.05;
+
+private:
+    struct Coefficients
+    {
+        float a1 = 1.0f, a2 = 0.0f, a3 = 0.0f; // Integrator update
+        float m1 = 0.0f;                       // Band-pass mix, zero at 0 dB
+    };
+
+    Coefficients makeCoefficients(float amplitude) const noexcept;
+
+    // The same filter advanced samplesPerStep samples at once: with state s = (ic1eq, ic2eq),
+    // s' = A s + B x and y = C s + D x per sample, these are the powers of A unrolled over a step
+    static constexpr int samplesPerStep = 4;
+
+    struct BlockCoefficients
+    {
+        float stateToState[2][2] = {};                             // A^N
+        float inputToState[2][samplesPerStep] = {};                // A^(N-1-j) B for input j
+        float stateToOutput[samplesPerStep][2] = {};               // C A^k for output k
+        float inputToOutput[samplesPerStep][samplesPerStep] = {};  // C A^(k-1-j) B below the diagonal, D on it
+    };
+
+    static BlockCoefficients makeBlockCoefficients(const Coefficients& c) noexcept;
+    void setCoefficients(const Coefficients& newCoefficients) noexcept; // Keeps the per-sample and block forms in step
+
+    template <typename Stage>
+    void run(juce::dsp::AudioBlock<float> block, const Stage& stage) noexcept; // The filter loops, with Stage applied to each output
+
+    float g = 0.0f;                                                                // tan(pi * frequency / sampleRate)
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> amplitude; // 10^(dB / 40), ramps linearly in dB
+    Coefficients coefficients;                                                     // For the current (settled) amplitude
+    BlockCoefficients blockCoefficients;                                           // The same, samplesPerStep at a time
+
+    int numChannelsPrepared = 0;
+    std::vector<float> ic1eq, ic2eq; // Integrator states, one per channel, padded to whole vectors
+    std::vector<float> peakLanes, sumSquareLanes; // Metering accumulators, same layout
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PeakFilter)
+};
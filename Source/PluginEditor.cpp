@@ -14,7 +14,7 @@
 
 //==============================================================================
 GainKnobAudioProcessorEditor::GainKnobAudioProcessorEditor(GainKnobAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), loadOverlay(p.loadProfiler), loudnessDisplay(p.loudness)
 {
 
     // Gain Knob
@@ -23,17 +23,11 @@ GainKnobAudioProcessorEditor::GainKnobAudioProcessorEditor(GainKnobAudioProcesso
     gainSlider.setRange(0.0, 10.0, 0.1);
     gainSlider.setValue(1.0);
     gainSlider.setLookAndFeel(&customLookAndFeel); // Apply custom LookAndFeel
-    gainSlider.onValueChange = [this]()
-        {
-            // Convert dB value to linear scale
-            float gainInLinear = std::pow(10.0f, static_cast<float>(gainSlider.getValue()) / 20.0f);
-            audioProcessor.gainValue.store(gainInLinear);
-        };
     addAndMakeVisible(gainSlider);
 
     // Attach gain parameter to the slider
     gainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "gain", gainSlider);
+        audioProcessor.parameters, Parameters::getParamID(Parameters::ID::gain), gainSlider);
 
     // EQ Knob
     eqKnob.setSliderStyle(juce::Slider::Rotary);
@@ -45,22 +39,85 @@ GainKnobAudioProcessorEditor::GainKnobAudioProcessorEditor(GainKnobAudioProcesso
 
     // Attach EQ boost parameter to the slider
     eqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "eqBoost", eqKnob);
+        audioProcessor.parameters, Parameters::getParamID(Parameters::ID::eqBoost), eqKnob);
 
     // Visualizer Component
     addAndMakeVisible(visualizer);
 
     addAndMakeVisible(levelMeters);
 
+    // Band count, curve and oversampling selectors, sitting on top of the visualizer
+    auto setUpChoiceBox = [this](juce::ComboBox& box, const juce::String& parameterID,
+                                 std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>& attachment)
+        {
+            if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.parameters.getParameter(parameterID)))
+                box.addItemList(choice->choices, 1); // Items must exist before the attachment is made
+
+            addAndMakeVisible(box);
+            attachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+                audioProcessor.parameters, parameterID, box);
+        };
+
+    setUpChoiceBox(oversamplingBox, Parameters::getParamID(Parameters::ID::oversampling), oversamplingAttachment);
+    setUpChoiceBox(oversamplingFilterBox, Parameters::getParamID(Parameters::ID::oversamplingFilter), oversamplingFilterAttachment);
+    setUpChoiceBox(saturationCurveBox, Parameters::getParamID(Parameters::ID::saturationCurve), saturationCurveAttachment);
+    setUpChoiceBox(bandsBox, Parameters::getParamID(Parameters::ID::bands), bandsAttachment);
+
+    // DSP load readout, hidden until asked for
+    loadButton.setClickingTogglesState(true);
+    loadButton.onClick = [this]
+        {
+            loadOverlay.setVisible(loadButton.getToggleState());
+            loadOverlay.update();
+        };
+    addAndMakeVisible(loadButton);
+    addChildComponent(loadOverlay);
+
+    // Waveform or spectrum; the spectrum's FFT runs on its own thread only while it's shown
+    spectrumButton.setClickingTogglesState(true);
+    spectrumButton.onClick = [this]
+        {
+            visualizer.setView(spectrumButton.getToggleState() ? VisualizerComponent::View::spectrum
+                                                                : VisualizerComponent::View::waveform);
+        };
+    addAndMakeVisible(spectrumButton);
+    visualizer.setSpectrumSource(&audioProcessor.telemetry);
+
+    // Output stage switches, lit while on
+    auto setUpToggle = [this](juce::TextButton& button, const juce::String& parameterID,
+                              std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment>& attachment)
+        {
+            button.setClickingTogglesState(true);
+            addAndMakeVisible(button);
+            attachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+                audioProcessor.parameters, parameterID, button);
+        };
+
+    setUpToggle(autoGainButton, Parameters::getParamID(Parameters::ID::autoGain), autoGainAttachment);
+    setUpToggle(limiterButton, Parameters::getParamID(Parameters::ID::limiter), limiterAttachment);
+
+    addAndMakeVisible(loudnessDisplay);
+    loudnessDisplay.update();
+
     gainSlider.setColour(juce::Slider::textBoxOutlineColourId, juce::Colours::transparentWhite); // Remove focus outline
     eqKnob.setColour(juce::Slider::textBoxOutlineColourId, juce::Colours::transparentWhite); // Remove focus outline
 
+    // The cached background covers every pixel, so nothing behind the editor needs painting
+    setOpaque(true);
+
     // Set the size of the plugin editor window
     setSize(400, 300);
+
+    // Start receiving levels and waveform data from the audio thread
+    audioProcessor.telemetry.setEnabled(true);
+    startTimerHz(30);
 }
 
 GainKnobAudioProcessorEditor::~GainKnobAudioProcessorEditor()
 {
+    stopTimer();
+    visualizer.setSpectrumSource(nullptr); // Joins the analyzer thread before the telemetry goes quiet
+    audioProcessor.telemetry.setEnabled(false);
 
     gainSlider.setLookAndFeel(nullptr);
     eqKnob.setLookAndFeel(nullptr);
@@ -70,6 +127,34 @@ GainKnobAudioProcessorEditor::~GainKnobAudioProcessorEditor()
 //==============================================================================
 void GainKnobAudioProcessorEditor::paint(juce::Graphics& g)
 {
+    // The background never changes for a given size, so it is drawn once into an image
+    // at the display's pixel scale and just blitted from then on
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (backgroundCache.isNull()
+        || backgroundCacheScale != scale
+        || backgroundCacheBounds != getLocalBounds())
+    {
+        const int imageWidth = juce::jmax(1, juce::roundToInt(getWidth() * scale));
+        const int imageHeight = juce::jmax(1, juce::roundToInt(getHeight() * scale));
+
+        backgroundCache = juce::Image(juce::Image::RGB, imageWidth, imageHeight, false);
+        backgroundCacheScale = scale;
+        backgroundCacheBounds = getLocalBounds();
+
+        juce::Graphics imageGraphics(backgroundCache);
+        imageGraphics.addTransform(juce::AffineTransform::scale((float)imageWidth / getWidth(), (float)imageHeight / getHeight()));
+        drawBackground(imageGraphics);
+    }
+
+    g.drawImage(backgroundCache, getLocalBounds().toFloat());
+}
+
+void GainKnobAudioProcessorEditor::drawBackground(juce::Graphics& g)
+{
+    // Fixed seed: the grain and scratches look the same on every repaint and every instance
+    juce::Random random(0x5a7ca1);
+
     // --- Enhanced Metallic Gradient Background ---
     juce::ColourGradient backgroundGradient(juce::Colours::darkgrey, 0, 0,         // Start color at top-left
         juce::Colours::lightgrey, getWidth(), // End color at bottom-right
@@ -83,8 +168,8 @@ void GainKnobAudioProcessorEditor::paint(juce::Graphics& g)
     g.setColour(juce::Colours::white.withAlpha(0.05f)); // Light, translucent white for grains
     for (int i = 0; i < 500; ++i) // 500 grains for a subtle effect
     {
-        int grainX = juce::Random::getSystemRandom().nextInt(getWidth());
-        int grainY = juce::Random::getSystemRandom().nextInt(getHeight());
+        int grainX = random.nextInt(getWidth());
+        int grainY = random.nextInt(getHeight());
         g.fillRect(grainX, grainY, 1, 1); // Draw tiny 1x1 pixel grains
     }
 
@@ -92,9 +177,9 @@ void GainKnobAudioProcessorEditor::paint(juce::Graphics& g)
     g.setColour(juce::Colours::white.withAlpha(0.1f)); // Thin, faint scratches
     for (int i = 0; i < 20; ++i) // 20 scratches for a balanced effect
     {
-        int startX = juce::Random::getSystemRandom().nextInt(getWidth());
-        int endX = startX + juce::Random::getSystemRandom().nextInt(50) + 50; // Random scratch length
-        int startY = juce::Random::getSystemRandom().nextInt(getHeight());
+        int startX = random.nextInt(getWidth());
+        int endX = startX + random.nextInt(50) + 50; // Random scratch length
+        int startY = random.nextInt(getHeight());
         g.drawLine(startX, startY, endX, startY, 0.5f); // Thin lines for scratches
     }
 
@@ -108,6 +193,50 @@ void GainKnobAudioProcessorEditor::paint(juce::Graphics& g)
 
 }
 
+void GainKnobAudioProcessorEditor::timerCallback()
+{
+    // Everything queued since the last tick: the meters get the loudest peak and the
+    // average power, the visualizer gets every waveform bucket in order
+    TelemetryFrame frame;
+    float peaks[TelemetryFrame::maxChannels] = {};
+    float meanSquares[TelemetryFrame::maxChannels] = {};
+    int numChannels = 0;
+    int numFrames = 0;
+
+    while (audioProcessor.telemetry.pop(frame))
+    {
+        numChannels = frame.numChannels;
+        ++numFrames;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            peaks[channel] = std::max(peaks[channel], frame.peaks[channel]);
+            meanSquares[channel] += frame.meanSquares[channel];
+        }
+    }
+
+    if (numChannels > 0)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            meanSquares[channel] /= (float)numFrames;
+
+        levelMeters.setLevels(peaks, meanSquares, numChannels);
+    }
+
+    levelMeters.tick(); // Ballistics on the same clock as the drain, so no tick ever misses a frame
+
+    visualizer.setSampleRate(audioProcessor.telemetry.getSampleRate());
+
+    WaveformBucket bucket;
+    while (audioProcessor.telemetry.popWaveform(bucket))
+        visualizer.addBucket(bucket);
+
+    if (loadOverlay.isVisible())
+        loadOverlay.update();
+
+    loudnessDisplay.update();
+}
+
 void GainKnobAudioProcessorEditor::resized()
 {
     // Define dimensions for the knobs
@@ -150,4 +279,22 @@ void GainKnobAudioProcessorEditor::resized()
 
     // Position the visualizer at the top
     visualizer.setBounds(0, 0, getWidth(), getHeight() - knobHeight - 60);
+
+    // Band count, curve and oversampling selectors in the top-right corner of the visualizer
+    bandsBox.setBounds(getWidth() - 260, 5, 60, 20);
+    saturationCurveBox.setBounds(getWidth() - 195, 5, 60, 20);
+    oversamplingBox.setBounds(getWidth() - 130, 5, 60, 20);
+    oversamplingFilterBox.setBounds(getWidth() - 65, 5, 60, 20);
+
+    // Load toggle and readout in the top-left corner
+    loadButton.setBounds(5, 5, 40, 20);
+    spectrumButton.setBounds(50, 5, 40, 20);
+    loadOverlay.setBounds(5, 30, 210, 36);
+
+    // Loudness readout in the bottom-right corner of the visualizer
+    loudnessDisplay.setBounds(getWidth() - 165, visualizer.getBottom() - 41, 160, 36);
+
+    // Output stage switches in the bottom corners, under the knobs
+    autoGainButton.setBounds(5, getHeight() - 25, 40, 20);
+    limiterButton.setBounds(getWidth() - 45, getHeight() - 25, 40, 20);
 }
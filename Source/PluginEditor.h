@@ -13,11 +13,13 @@
 #include "VisualizerComponent.h"
 #include "CustomLookAndFeel.h"
 #include "LevelMeterComponent.h" // Include the new class
+#include "LoadOverlayComponent.h"
+#include "LoudnessComponent.h"
 
 //==============================================================================
 /**
 */
-class GainKnobAudioProcessorEditor : public juce::AudioProcessorEditor
+class GainKnobAudioProcessorEditor : public juce::AudioProcessorEditor, private juce::Timer
 {
 public:
     GainKnobAudioProcessorEditor(GainKnobAudioProcessor&);
@@ -34,6 +36,13 @@ public:
     LevelMeterComponent levelMeters; // Add level meters
 
 private:
+    void timerCallback() override; // Drains the processor's telemetry into the meters and visualizer
+    void drawBackground(juce::Graphics& g); // Gradient, grain, scratches and labels, rendered into backgroundCache
+
+    juce::Image backgroundCache;              // Pre-rendered background for the current size and scale
+    juce::Rectangle<int> backgroundCacheBounds;
+    float backgroundCacheScale = 0.0f;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     GainKnobAudioProcessor& audioProcessor;
@@ -45,5 +54,24 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eqAttachment;
 
+    juce::ComboBox oversamplingBox;       // 1x/2x/4x/8x around the saturation
+    juce::ComboBox oversamplingFilterBox; // IIR or FIR anti-aliasing filters
+    juce::ComboBox saturationCurveBox;    // Soft knee, tanh, tube or hard clip
+    juce::ComboBox bandsBox;              // 1 to 4 saturation bands; the per-band drives are host parameters
+
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingFilterAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> saturationCurveAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> bandsAttachment;
+
+    juce::TextButton loadButton{ "CPU" }; // Shows or hides the load overlay
+    juce::TextButton spectrumButton{ "FFT" }; // Switches the visualizer between waveform and spectrum
+    juce::TextButton autoGainButton{ "AGC" }; // Auto gain on/off
+    juce::TextButton limiterButton{ "LIM" };  // Output limiter on/off; the lookahead is a host parameter
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> autoGainAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> limiterAttachment;
+    LoadOverlayComponent loadOverlay;
+    LoudnessComponent loudnessDisplay; // Reads the processor's meter, so it picks up where it was when reopened
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GainKnobAudioProcessorEditor)
 };
@@ -8,9 +8,44 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "RealtimeSanitizer.h"
+#include "SimdFloat.h"
 #include <juce_dsp/juce_dsp.h>
 
 
+namespace
+{
+    // True if no sample in the block reaches threshold. Vectorised, and stops at the first loud stretch.
+    bool isSilent(const juce::dsp::AudioBlock<float>& block, float threshold) noexcept
+    {
+        constexpr int stretch = 64;
+        const int numSamples = (int)block.getNumSamples();
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            const float* data = block.getChannelPointer(channel);
+            int i = 0;
+
+            while (i + SimdFloat::size <= numSamples)
+            {
+                auto peak = SimdFloat::broadcast(0.0f);
+                const int end = juce::jmin(numSamples - SimdFloat::size + 1, i + stretch);
+
+                for (; i < end; i += SimdFloat::size)
+                    peak = SimdFloat::max(peak, SimdFloat::abs(SimdFloat::load(data + i)));
+
+                if (peak.reduceMax() >= threshold)
+                    return false;
+            }
+
+            for (; i < numSamples; ++i)
+                if (std::abs(data[i]) >= threshold)
+                    return false;
+        }
+
+        return true;
+    }
+}
 
 //==============================================================================
 GainKnobAudioProcessor::GainKnobAudioProcessor()
@@ -23,11 +58,8 @@ GainKnobAudioProcessor::GainKnobAudioProcessor()
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
     ),
-    parameters(*this, nullptr, "PARAMETERS",
-        {
-            std::make_unique<juce::AudioParameterFloat>("gain", "Gain", 0.0f, 10.0f, 1.0f),
-            std::make_unique<juce::AudioParameterFloat>("eqBoost", "EQ Boost", 0.0f, 10.0f, 0.0f)
-        })
+    parameters(*this, nullptr, "PARAMETERS", Parameters::createLayout()),
+    parameterHandles(parameters)
 #endif
 {
 }
@@ -71,7 +103,11 @@ bool GainKnobAudioProcessor::isMidiEffect() const
 
 double GainKnobAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // How long the output keeps going after the input stops: the latency, then the EQ and crossover rings.
+    // Hosts may ask from any thread, so everything here is read through atomics.
+    const auto params = parameterHandles.snapshot();
+
+    return latencySeconds.load() + PeakFilter::getTailSeconds(params.eqBoost) + multiband.getTailSeconds();
 }
 
 int GainKnobAudioProcessor::getNumPrograms()
@@ -101,20 +137,177 @@ void GainKnobAudioProcessor::changeProgramName(int index, const juce::String& ne
 //==============================================================================
 void GainKnobAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    // Initialize EQ filter coefficients with a default gain of 0 dB
-    eqCoefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate, 400.0f, 0.707f, juce::Decibels::decibelsToGain(0.0f));
-
-    // Resize filters to match the number of channels
-    eqFilters.resize(getTotalNumInputChannels());
-    for (auto& filter : eqFilters)
-        filter.coefficients = eqCoefficients;
+    telemetry.setSampleRate(sampleRate);
+    loadProfiler.prepare(sampleRate);
+    loudness.prepare(sampleRate, getChannelLayoutOfBus(false, 0));
+
+    const auto params = parameterHandles.snapshot();
+
+    // Start the EQ and the gain at their current values so the first block doesn't ramp
+    eqFilter.prepare(sampleRate, getTotalNumInputChannels(), params.eqBoost);
+    gainRamp.reset(sampleRate, gainRampSeconds);
+    gainRamp.setCurrentAndTargetValue(params.gain);
+
+    // The bands are split at whatever rate the saturation runs, set in updateOversampling
+    preparedSampleRate = sampleRate;
+    multiband.prepare(sampleRate, getTotalNumInputChannels());
+    multiband.setNumBands(params.bands + 1);
+
+    autoGain.prepare(sampleRate);
+    autoGain.setEnabled(params.autoGain);
+
+    limiter.prepare(sampleRate, getTotalNumInputChannels());
+    limiter.setLookaheadMs(params.limiterLookahead);
+    limiterWasOn = params.limiter;
+
+    // Build every oversampler up front so switching factor or filter never allocates
+    const auto numChannels = (size_t)juce::jmax(1, getTotalNumInputChannels());
+    maxBlockSize = juce::jmax(1, samplesPerBlock);
+
+    for (int filter = 0; filter < numOversamplingFilters; ++filter)
+    {
+        const auto filterType = filter == 0 ? juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR
+                                            : juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple;
+
+        for (int factor = 1; factor < numOversamplingFactors; ++factor)
+        {
+            auto& oversampler = oversamplers[(size_t)(filter * numOversamplingFactors + factor)];
+            oversampler = std::make_unique<juce::dsp::Oversampling<float>>(numChannels, (size_t)factor, filterType, true, true);
+            oversampler->initProcessing((size_t)maxBlockSize);
+        }
+    }
+
+    currentOversampler = -1; // Forces the oversampler and the latency to be picked up again
+    reportedLatency = -1;
+    silentSamples = 0;
+    isSleeping = false;
+    updateOversampling(params);
+    updateLatency(params);
+}
+
+void GainKnobAudioProcessor::updateOversampling(const Parameters::Snapshot& params)
+{
+    const int factor = params.oversampling;
+    const int filter = params.oversamplingFilter;
+    const int index = factor == 0 ? 0 : filter * numOversamplingFactors + factor;
+
+    if (index == currentOversampler)
+        return;
+
+    currentOversampler = index;
+
+    // The crossovers follow the rate the saturation runs at; no allocation, just new coefficients
+    multiband.setSampleRate(preparedSampleRate * (double)(1 << factor));
+
+    if (auto* oversampler = oversamplers[(size_t)index].get())
+    {
+        oversampler->reset(); // Don't replay a stale filter state from the last time this mode was used
+        oversamplingLatency = (int)oversampler->getLatencyInSamples();
+    }
+    else
+    {
+        oversamplingLatency = 0;
+    }
+}
+
+void GainKnobAudioProcessor::updateLatency(const Parameters::Snapshot& params)
+{
+    const int latency = oversamplingLatency + (params.limiter ? limiter.getLatencySamples() : 0);
+
+    if (latency == reportedLatency)
+        return;
+
+    reportedLatency = latency;
+    latencySeconds.store(latency > 0 ? latency / preparedSampleRate : 0.0);
+
+    // Hosts expect latency changes to be reported from here, and JUCE takes its listener
+    // lock to do it. It only happens when the oversampling mode, the limiter or its lookahead changes.
+    const RealtimeSanitizer::ScopedAllow allowLatencyUpdate;
+    setLatencySamples(latency);
+}
+
+bool GainKnobAudioProcessor::updateSleep(const juce::dsp::AudioBlock<float>& input)
+{
+    if (! isSilent(input, silenceThreshold))
+    {
+        silentSamples = 0;
+        isSleeping = false;
+        return false;
+    }
+
+    silentSamples += (juce::int64)input.getNumSamples();
+
+    if (isSleeping)
+        return true;
+
+    // The delay lines (oversampler, limiter) are empty once the latency has passed twice over;
+    // the recursive filters say themselves when they've rung out
+    const auto flushSamples = 2 * (juce::int64)juce::jmax(0, reportedLatency) + sleepMarginSamples;
+
+    if (silentSamples < flushSamples || ! eqFilter.isQuiet(silenceThreshold) || ! multiband.isQuiet(silenceThreshold))
+        return false;
+
+    // Start from exact zeros when the input comes back
+    eqFilter.reset();
+    multiband.reset();
+    limiter.reset();
+
+    if (auto* oversampler = oversamplers[(size_t)currentOversampler].get())
+        oversampler->reset();
+
+    isSleeping = true;
+    return true;
+}
+
+void GainKnobAudioProcessor::processGainAndSaturation(juce::dsp::AudioBlock<float> block, const Parameters::Snapshot& params,
+                                                      float startGain, float endGain)
+{
+    const auto curve = (SaturationKernel::Curve)params.saturationCurve;
+
+    std::array<float, MultibandSaturator::maxBands> bandDrives;
+    for (size_t band = 0; band < bandDrives.size(); ++band)
+        bandDrives[band] = juce::Decibels::decibelsToGain(params.bandDriveDecibels[band]);
+
+    // The gain ramps linearly from startGain to endGain across the target (equal when it isn't moving)
+    auto saturate = [&](juce::dsp::AudioBlock<float> target, float from, float to)
+    {
+        if (multiband.getNumBands() > 1)
+        {
+            multiband.process(target, from, to, bandDrives.data(), curve);
+            return;
+        }
+
+        for (size_t channel = 0; channel < target.getNumChannels(); ++channel)
+            SaturationKernel::process(curve, target.getChannelPointer(channel), (int)target.getNumSamples(), from, to);
+    };
+
+    auto* oversampler = oversamplers[(size_t)currentOversampler].get();
+
+    if (oversampler == nullptr)
+    {
+        saturate(block, startGain, endGain);
+        return;
+    }
+
+    // The oversampler was prepared for maxBlockSize, so feed it no more than that at a time.
+    // Each piece takes its stretch of the ramp, spread over the oversampled samples.
+    const auto numSamples = block.getNumSamples();
+    auto gainAt = [&](size_t position) { return startGain + (endGain - startGain) * (float)position / (float)numSamples; };
+
+    for (size_t start = 0; start < numSamples; start += (size_t)maxBlockSize)
+    {
+        const auto length = juce::jmin((size_t)maxBlockSize, numSamples - start);
+        auto subBlock = block.getSubBlock(start, length);
+        saturate(oversampler->processSamplesUp(subBlock), gainAt(start), gainAt(start + length));
+        oversampler->processSamplesDown(subBlock);
+    }
 }
 
 void GainKnobAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    loudness.release(); // Off the worker thread; the readings stay for the next prepareToPlay
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -124,12 +317,9 @@ bool GainKnobAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
     juce::ignoreUnused(layouts);
     return true;
 #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Every channel goes through the same EQ and saturation, so any layout works:
+    // mono, stereo, 5.1, 7.1.4, ambisonics... as long as the main bus is enabled.
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
     // This checks if the input layout matches the output layout
@@ -145,6 +335,8 @@ bool GainKnobAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 
 void GainKnobAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    const RealtimeSanitizer::ScopedRealtime realtimeScope; // Debug builds flag any allocation or lock from here on
+    const LoadProfiler::ScopedBlock loadScope(loadProfiler, buffer.getNumSamples());
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -153,77 +345,141 @@ void GainKnobAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Get the current gain and EQ boost values
-    float gain = parameters.getRawParameterValue("gain")->load();
-    float eqBoost = parameters.getRawParameterValue("eqBoost")->load();
+    // Every parameter value for this block, read through the cached handles
+    const auto params = parameterHandles.snapshot();
 
-    // Update EQ coefficients only if the knob value changes
-    if (eqBoost != previousEqBoost)
-    {
-        float gainInDecibels = juce::Decibels::decibelsToGain(eqBoost);
-        eqCoefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-            getSampleRate(), 400.0f, 0.707f, gainInDecibels);
+    // The gain ramps towards a new value sample by sample, so automation doesn't step at block boundaries
+    gainRamp.setTargetValue(params.gain);
 
-        for (auto& filter : eqFilters)
-            filter.coefficients = eqCoefficients;
+    // The EQ ramps towards the new boost itself, so automation never allocates or zippers
+    eqFilter.setGainDecibels(params.eqBoost);
 
-        previousEqBoost = eqBoost;
-    }
+    updateOversampling(params);
+    multiband.setNumBands(params.bands + 1); // Clears the band filters when the count changes
+    autoGain.setEnabled(params.autoGain);
+
+    // A new lookahead restarts the limiter and changes the latency reported below, like a new
+    // oversampling factor. It moves in 0.5 ms steps, so sweeping it restarts the limiter once per
+    // step rather than every block. Switching the limiter on restarts it too, so it doesn't replay
+    // a stale delay line.
+    const bool limiterOn = params.limiter;
+    limiter.setLookaheadMs(params.limiterLookahead);
+
+    if (limiterOn && ! limiterWasOn)
+        limiter.reset();
+
+    limiterWasOn = limiterOn;
+    updateLatency(params);
 
     // Wrap the buffer in a DSP block
     juce::dsp::AudioBlock<float> audioBlock(buffer);
 
-    // Variables to track peak levels for left and right channels
-    float leftChannelLevel = 0.0f;
-    float rightChannelLevel = 0.0f;
+    // Metering is only worth doing while an editor is there to show it
+    const bool wantsMetering = telemetry.isEnabled() && totalNumInputChannels > 0;
+    bool isMetered = false;
 
-    // Process each channel
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    TelemetryFrame frame;
+    frame.numChannels = juce::jmin(totalNumInputChannels, TelemetryFrame::maxChannels);
+
+    if (totalNumInputChannels > 0)
     {
-        auto channelBlock = audioBlock.getSingleChannelBlock(channel);
-        juce::dsp::ProcessContextReplacing<float> context(channelBlock);
+        auto inputBlock = audioBlock.getSubsetChannelBlock(0, (size_t)totalNumInputChannels);
 
-        // Apply EQ filter for this channel
-        eqFilters[channel].process(context);
+        if (updateSleep(inputBlock))
+        {
+            // Idle: none of the DSP runs, the output is silence and so are the meters
+            inputBlock.clear();
+            gainRamp.skip((int)inputBlock.getNumSamples()); // Wake up at the current gain, not mid-ramp
 
-        // Apply gain and saturation manually
-        auto* channelData = buffer.getWritePointer(channel);
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            std::fill(frame.peaks, frame.peaks + frame.numChannels, 0.0f);
+            std::fill(frame.meanSquares, frame.meanSquares + frame.numChannels, 0.0f);
+            isMetered = true;
+        }
+        else
         {
-            float processedSample = channelData[sample] * gain;
+            autoGain.measureInput(inputBlock); // Before anything touches the block
 
-            // Apply soft saturation
-            if (gain > 1.0f)
+            // While the gain is still ramping, that stretch takes the ramped kernels; the rest of the
+            // block, usually all of it, runs at the settled gain with no smoothing cost at all
+            const int numSamples = (int)inputBlock.getNumSamples();
+            const int rampSamples = juce::jmin(numSamples, gainRamp.getRemainingSamples());
+
+            if (rampSamples > 0)
             {
-                float threshold = 0.8f;
-                if (processedSample > threshold)
-                    processedSample = threshold + (processedSample - threshold) / (1.0f + std::pow(processedSample - threshold, 2));
-                else if (processedSample < -threshold)
-                    processedSample = -threshold + (processedSample + threshold) / (1.0f + std::pow(processedSample + threshold, 2));
+                const float startGain = gainRamp.getCurrentValue();
+                const float endGain = gainRamp.skip(rampSamples);
+                auto rampBlock = inputBlock.getSubBlock(0, (size_t)rampSamples);
+
+                eqFilter.process(rampBlock);
+                processGainAndSaturation(rampBlock, params, startGain, endGain);
             }
 
-            channelData[sample] = processedSample;
-        }
+            if (rampSamples < numSamples)
+            {
+                auto settledBlock = inputBlock.getSubBlock((size_t)rampSamples);
+                const float gain = gainRamp.getTargetValue();
+
+                if (currentOversampler == 0 && multiband.getNumBands() == 1)
+                {
+                    // No oversampling, one band: EQ, gain, saturation and metering in a single pass over each sample
+                    PeakFilter::GainStage stage{ gain, (SaturationKernel::Curve)params.saturationCurve };
+
+                    // With auto gain or the limiter the level still changes after this pass, so the meters are read afterwards instead.
+                    // So are blocks that started with a ramp, since the pass only sees the settled part.
+                    if (wantsMetering && totalNumInputChannels <= TelemetryFrame::maxChannels && ! autoGain.isActive() && ! limiterOn
+                        && rampSamples == 0)
+                    {
+                        stage.peaks = frame.peaks;
+                        stage.meanSquares = frame.meanSquares;
+                        isMetered = true;
+                    }
+
+                    eqFilter.process(settledBlock, stage);
+                }
+                else
+                {
+                    // The saturation runs at the higher rate or per band, so the EQ goes first on its own
+                    eqFilter.process(settledBlock);
+
+                    // Apply gain and saturation, oversampled and/or split into bands (see SaturationKernel.h, MultibandSaturator.h)
+                    processGainAndSaturation(settledBlock, params, gain, gain);
+                }
+            }
+
+            autoGain.process(inputBlock); // Running input/output power, then the smoothed makeup
 
-        // Calculate peak levels for each channel
-        if (channel == 0) // Left channel
-            leftChannelLevel = std::max(leftChannelLevel, buffer.getMagnitude(channel, 0, buffer.getNumSamples()));
-        else if (channel == 1) // Right channel
-            rightChannelLevel = std::max(rightChannelLevel, buffer.getMagnitude(channel, 0, buffer.getNumSamples()));
+            if (limiterOn)
+                limiter.process(inputBlock);
+        }
     }
 
-    // Send levels to the editor
-    if (auto* editor = dynamic_cast<GainKnobAudioProcessorEditor*>(getActiveEditor()))
-    {
-        // Update level meters
-        editor->levelMeters.setLevels(leftChannelLevel, rightChannelLevel);
+    // Loudness is measured all the time; this only copies the block into the meter's queue
+    loudness.push(buffer.getArrayOfReadPointers(), totalNumOutputChannels, buffer.getNumSamples());
 
-        // Push a sample from the left channel to the visualizer
-        if (totalNumInputChannels > 0)
+    if (wantsMetering)
+    {
+        // Oversampled (or very wide) blocks are measured after the fact
+        if (! isMetered)
         {
-            float sampleToPush = buffer.getReadPointer(0)[0]; // First sample of the left channel
-            editor->visualizer.pushSample(sampleToPush);
+            for (int channel = 0; channel < frame.numChannels; ++channel)
+            {
+                const float rms = buffer.getRMSLevel(channel, 0, buffer.getNumSamples());
+                frame.peaks[channel] = buffer.getMagnitude(channel, 0, buffer.getNumSamples());
+                frame.meanSquares[channel] = rms * rms;
+            }
         }
+
+        telemetry.push(frame);
+
+        // Min/max waveform buckets for the visualizer (mono feeds both sides)
+        auto* left = buffer.getReadPointer(0);
+        auto* right = totalNumInputChannels > 1 ? buffer.getReadPointer(1) : left;
+        telemetry.pushWaveform(left, right, buffer.getNumSamples());
+        telemetry.pushSpectrum(left, right, buffer.getNumSamples()); // No-op unless the spectrum view is showing
+    }
+    else
+    {
+        telemetry.waveformIdle();
     }
 }
 
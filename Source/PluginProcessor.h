@@ -10,6 +10,16 @@
 
 #include <JuceHeader.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "AudioTelemetry.h"
+#include "AutoGain.h"
+#include "GainRamp.h"
+#include "LoadProfiler.h"
+#include "LookaheadLimiter.h"
+#include "LoudnessMeter.h"
+#include "MultibandSaturator.h"
+#include "PeakFilter.h"
+#include "Parameters.h"
+#include "SaturationKernel.h"
 
 
 //==============================================================================
@@ -55,18 +65,46 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    std::atomic<float> gainValue{ 0.5f }; // Initial gain value
-
     juce::AudioProcessorValueTreeState parameters;
+    const Parameters::Handles parameterHandles; // Typed, cached access to the values above (see Parameters.h)
 
+    AudioTelemetry telemetry; // Peak levels and waveform data for the editor, drained on the message thread
+    LoadProfiler loadProfiler; // Time taken by every processBlock against its deadline
+    LoudnessMeter loudness;    // LUFS and true peak of the output, measured on a shared worker thread whether or not the editor is open
 
 
 private:
-
-    float previousEqBoost = 0.0f;
-
-    std::vector<juce::dsp::IIR::Filter<float>> eqFilters; // Array of EQ filters for each channel
-    juce::dsp::IIR::Coefficients<float>::Ptr eqCoefficients; // Shared coefficients
+    void updateOversampling(const Parameters::Snapshot& params); // Picks up the oversampling parameters
+    void updateLatency(const Parameters::Snapshot& params);      // Oversampling plus limiter lookahead, reported when it changes
+    bool updateSleep(const juce::dsp::AudioBlock<float>& input); // True when this block can be skipped and output as silence
+    void processGainAndSaturation(juce::dsp::AudioBlock<float> block, const Parameters::Snapshot& params,
+                                  float startGain, float endGain);
+
+    PeakFilter eqFilter; // Harmonic Boost bell, smoothed and allocation-free on the audio thread
+    GainRamp gainRamp;   // Per-sample smoothing of the gain knob and its automation
+    static constexpr double gainRampSeconds = 0.02;
+    MultibandSaturator multiband; // Splits the saturation into bands when the Bands parameter is above 1
+    AutoGain autoGain;            // Optional makeup so the drive doesn't change the output level
+    LookaheadLimiter limiter;     // Optional 0 dBFS ceiling, last in the chain
+    bool limiterWasOn = false;
+
+    // Oversampling around the gain and saturation stage, indexed by filter * numOversamplingFactors + log2(factor).
+    // Slot 0 (and every 1x slot) stays empty and means no oversampling.
+    static constexpr int numOversamplingFactors = 4; // 1x, 2x, 4x, 8x
+    static constexpr int numOversamplingFilters = 2; // Polyphase IIR, linear-phase FIR
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, numOversamplingFactors * numOversamplingFilters> oversamplers;
+    int currentOversampler = 0;
+    int oversamplingLatency = 0; // Samples at the host rate
+    int reportedLatency = -1;
+    std::atomic<double> latencySeconds{ 0.0 }; // The same in seconds, for getTailLengthSeconds on any thread
+
+    // Idle detection: silent input for long enough, and nothing left ringing in the filters
+    static constexpr float silenceThreshold = 1.0e-6f; // -120 dBFS
+    static constexpr int sleepMarginSamples = 64;      // On top of twice the latency, for the oversampling filters to flush
+    juce::int64 silentSamples = 0;
+    bool isSleeping = false;
+    int maxBlockSize = 0;
+    double preparedSampleRate = 44100.0;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GainKnobAudioProcessor)
@@ -0,0 +1,207 @@
+#include "RealtimeSanitizer.h"
+
+#if SATGAIN_REALTIME_SANITIZER
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX
+ #include <cstdarg>
+ #include <dlfcn.h> // Link with -ldl on glibc older than 2.34
+ #include <fcntl.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+namespace RealtimeSanitizer
+{
+    namespace
+    {
+        // Plain thread_local ints: they live in static TLS, so reading them from inside
+        // malloc doesn't allocate
+        thread_local int realtimeDepth = 0;
+        thread_local int allowDepth = 0;
+        thread_local bool isReporting = false;
+
+        std::atomic<Mode> mode{ Mode::log };
+        std::atomic<int> numViolations{ 0 };
+
+        bool isViolation() noexcept
+        {
+            return realtimeDepth > 0 && allowDepth == 0 && ! isReporting;
+        }
+
+        void report(const char* what) noexcept
+        {
+            isReporting = true; // The report itself allocates and writes, which mustn't recurse
+            ++numViolations;
+
+            {
+                const auto message = juce::String("Real-time violation: ") + what + " on the audio thread\n"
+                                   + juce::SystemStats::getStackBacktrace();
+                std::fputs(message.toRawUTF8(), stderr);
+                std::fflush(stderr);
+            }
+
+            if (mode.load() == Mode::abort)
+                std::abort();
+
+            isReporting = false;
+        }
+
+        void check(const char* what) noexcept
+        {
+            if (isViolation())
+                report(what);
+        }
+    }
+
+    void setMode(Mode newMode) noexcept { mode = newMode; }
+    int getNumViolations() noexcept { return numViolations.load(); }
+    void resetViolations() noexcept { numViolations = 0; }
+
+    ScopedRealtime::ScopedRealtime() noexcept { ++realtimeDepth; }
+    ScopedRealtime::~ScopedRealtime() noexcept { --realtimeDepth; }
+
+    ScopedAllow::ScopedAllow() noexcept { ++allowDepth; }
+    ScopedAllow::~ScopedAllow() noexcept { --allowDepth; }
+}
+
+//==============================================================================
+#if JUCE_LINUX
+
+// glibc exports its allocator under these names, so the interposers don't need dlsym
+// (which can itself allocate) to find the real ones
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void* __libc_memalign(size_t, size_t);
+extern "C" void __libc_free(void*);
+
+namespace
+{
+    template <typename Function>
+    Function findNext(const char* name) noexcept
+    {
+        return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+    }
+
+    // Resolved at start-up so the first real-time call doesn't go through the dynamic linker
+    struct RealFunctions
+    {
+        decltype(&pthread_mutex_lock) mutexLock = findNext<decltype(&pthread_mutex_lock)>("pthread_mutex_lock");
+        decltype(&pthread_rwlock_rdlock) readLock = findNext<decltype(&pthread_rwlock_rdlock)>("pthread_rwlock_rdlock");
+        decltype(&pthread_rwlock_wrlock) writeLock = findNext<decltype(&pthread_rwlock_wrlock)>("pthread_rwlock_wrlock");
+        decltype(&pthread_cond_wait) conditionWait = findNext<decltype(&pthread_cond_wait)>("pthread_cond_wait");
+        decltype(&sem_wait) semaphoreWait = findNext<decltype(&sem_wait)>("sem_wait");
+        decltype(&nanosleep) sleep = findNext<decltype(&nanosleep)>("nanosleep");
+        int (*open)(const char*, int, ...) = findNext<int (*)(const char*, int, ...)>("open");
+        decltype(&::read) read = findNext<decltype(&::read)>("read");
+        decltype(&::write) write = findNext<decltype(&::write)>("write");
+    };
+
+    const RealFunctions& real() noexcept
+    {
+        static const RealFunctions functions;
+        return functions;
+    }
+
+    const auto& resolvedAtStartup = real();
+}
+
+extern "C"
+{
+    void* malloc(size_t size)                     { RealtimeSanitizer::check("malloc");  return __libc_malloc(size); }
+    void* calloc(size_t count, size_t size)       { RealtimeSanitizer::check("calloc");  return __libc_calloc(count, size); }
+    void* realloc(void* pointer, size_t size)     { RealtimeSanitizer::check("realloc"); return __libc_realloc(pointer, size); }
+    void* memalign(size_t alignment, size_t size) { RealtimeSanitizer::check("memalign"); return __libc_memalign(alignment, size); }
+    void* aligned_alloc(size_t alignment, size_t size) { RealtimeSanitizer::check("aligned_alloc"); return __libc_memalign(alignment, size); }
+
+    int posix_memalign(void** result, size_t alignment, size_t size)
+    {
+        RealtimeSanitizer::check("posix_memalign");
+        *result = __libc_memalign(alignment, size);
+        return *result != nullptr || size == 0 ? 0 : ENOMEM;
+    }
+
+    void free(void* pointer)
+    {
+        if (pointer != nullptr)
+            RealtimeSanitizer::check("free");
+
+        __libc_free(pointer);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex)            { RealtimeSanitizer::check("pthread_mutex_lock");    return real().mutexLock(mutex); }
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock)         { RealtimeSanitizer::check("pthread_rwlock_rdlock"); return real().readLock(lock); }
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock)         { RealtimeSanitizer::check("pthread_rwlock_wrlock"); return real().writeLock(lock); }
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex) { RealtimeSanitizer::check("pthread_cond_wait"); return real().conditionWait(condition, mutex); }
+    int sem_wait(sem_t* semaphore)                            { RealtimeSanitizer::check("sem_wait");              return real().semaphoreWait(semaphore); }
+    int nanosleep(const timespec* duration, timespec* remaining) { RealtimeSanitizer::check("nanosleep");          return real().sleep(duration, remaining); }
+    ssize_t read(int file, void* data, size_t size)           { RealtimeSanitizer::check("read");                  return real().read(file, data, size); }
+    ssize_t write(int file, const void* data, size_t size)    { RealtimeSanitizer::check("write");                 return real().write(file, data, size); }
+
+    int open(const char* path, int flags, ...)
+    {
+        RealtimeSanitizer::check("open");
+
+        va_list args;
+        va_start(args, flags);
+        // O_TMPFILE carries the O_DIRECTORY bit, so it has to match in full
+        const bool takesMode = (flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE;
+        const auto permissions = takesMode ? va_arg(args, int) : 0;
+        va_end(args);
+
+        return real().open(path, flags, permissions);
+    }
+}
+
+#else
+
+//==============================================================================
+// Without interposition the best available is the C++ allocator
+void* operator new(size_t size)
+{
+    RealtimeSanitizer::check("operator new");
+
+    if (auto* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeSanitizer::check("operator new");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        RealtimeSanitizer::check("operator delete");
+
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept                   { operator delete(pointer); }
+void operator delete(void* pointer, size_t) noexcept             { operator delete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept           { operator delete(pointer); }
+
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Debug check that the audio thread stays real-time safe.
+//
+// Build with SATGAIN_REALTIME_SANITIZER=1 (SatGainBenchmarkRealtime in Tools/CMakeLists.txt
+// is, and ctest runs it) and any heap allocation, mutex lock or blocking system call made
+// while a ScopedRealtime is alive on the current thread is reported with a stack trace, or
+// aborts in Mode::abort.
+//
+// On Linux the malloc family, pthread locks and the usual blocking calls are interposed, so
+// JUCE and the standard library are caught too. Elsewhere only operator new/delete can be
+// replaced. The interposers are process-wide: only turn this on for executables, never for
+// the plugin itself, where it would take over the host's allocator.
+//
+// With the flag off, everything here compiles to nothing.
+#ifndef SATGAIN_REALTIME_SANITIZER
+ #define SATGAIN_REALTIME_SANITIZER 0
+#endif
+
+namespace RealtimeSanitizer
+{
+    enum class Mode
+    {
+        log,  // Print the violation and its stack, then carry on
+        abort // Print, then stop right there so a debugger lands on it
+    };
+
+#if SATGAIN_REALTIME_SANITIZER
+    void setMode(Mode newMode) noexcept;
+    int getNumViolations() noexcept;
+    void resetViolations() noexcept;
+
+    // Marks the calling thread as real-time for its lifetime. Nests.
+    class ScopedRealtime
+    {
+    public:
+        ScopedRealtime() noexcept;
+        ~ScopedRealtime() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtime)
+    };
+
+    // Lets a known, accepted exception through (say why at the call site)
+    class ScopedAllow
+    {
+    public:
+        ScopedAllow() noexcept;
+        ~ScopedAllow() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllow)
+    };
+#else
+    inline void setMode(Mode) noexcept {}
+    inline int getNumViolations() noexcept { return 0; }
+    inline void resetViolations() noexcept {}
+
+    struct ScopedRealtime { ScopedRealtime() noexcept {} };
+    struct ScopedAllow { ScopedAllow() noexcept {} };
+#endif
+}
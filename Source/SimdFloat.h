@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX512F__)
+ #define SATGAIN_SIMD_AVX512 1
+#elif defined(__AVX__)
+ #define SATGAIN_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define SATGAIN_SIMD_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+ #define SATGAIN_SIMD_NEON 1
+#endif
+
+#if SATGAIN_SIMD_AVX512 || SATGAIN_SIMD_AVX || SATGAIN_SIMD_SSE
+ #include <immintrin.h>
+#elif SATGAIN_SIMD_NEON
+ #include <arm_neon.h>
+#endif
+
+// Thin wrapper around the widest float vector the target was compiled for.
+// juce::dsp::SIMDRegister has no division or sign operations, which the DSP kernels need,
+// so this maps straight onto the intrinsics: 16 lanes with AVX-512, 8 with AVX,
+// 4 with SSE2/NEON and a single scalar lane otherwise.
+struct SimdFloat
+{
+#if SATGAIN_SIMD_AVX512
+    using Native = __m512;
+    static constexpr int size = 16;
+#elif SATGAIN_SIMD_AVX
+    using Native = __m256;
+    static constexpr int size = 8;
+#elif SATGAIN_SIMD_SSE
+    using Native = __m128;
+    static constexpr int size = 4;
+#elif SATGAIN_SIMD_NEON
+    using Native = float32x4_t;
+    static constexpr int size = 4;
+#else
+    using Native = float;
+    static constexpr int size = 1;
+#endif
+
+    Native value;
+
+    //==============================================================================
+    static SimdFloat load(const float* source) noexcept // Unaligned load
+    {
+#if SATGAIN_SIMD_AVX512
+        return { _mm512_loadu_ps(source) };
+#elif SATGAIN_SIMD_AVX
+        return { _mm256_loadu_ps(source) };
+#elif SATGAIN_SIMD_SSE
+        return { _mm_loadu_ps(source) };
+#elif SATGAIN_SIMD_NEON
+        return { vld1q_f32(source) };
+#else
+        return { *source };
+#endif
+    }
+
+    void store(float* dest) const noexcept // Unaligned store
+    {
+#if SATGAIN_SIMD_AVX512
+        _mm512_storeu_ps(dest, value);
+#elif SATGAIN_SIMD_AVX
+        _mm256_storeu_ps(dest, value);
+#elif SATGAIN_SIMD_SSE
+        _mm_storeu_ps(dest, value);
+#elif SATGAIN_SIMD_NEON
+        vst1q_f32(dest, value);
+#else
+        *dest = value;
+#endif
+    }
+
+    static SimdFloat broadcast(float x) noexcept
+    {
+#if SATGAIN_SIMD_AVX512
+        return { _mm512_set1_ps(x) };
+#elif SATGAIN_SIMD_AVX
+        return { _mm256_set1_ps(x) };
+#elif SATGAIN_SIMD_SSE
+        return { _mm_set1_ps(x) };
+#elif SATGAIN_SIMD_NEON
+        return { vdupq_n_f32(x) };
+#else
+        return { x };
+#endif
+    }
+
+    //==============================================================================
+    friend SimdFloat operator+(SimdFloat a, SimdFloat b) noexcept
+    {
+#if SATGAIN_SIMD_AVX512
+        return { _mm512_add_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_AVX
+        return { _mm256_add_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_SSE
+        return { _mm_add_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_NEON
+        return { vaddq_f32(a.value, b.value) };
+#else
+        return { a.value + b.value };
+#endif
+    }
+
+    friend SimdFloat operator-(SimdFloat a, SimdFloat b) noexcept
+    {
+#if SATGAIN_SIMD_AVX512
+        return { _mm512_sub_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_AVX
+        return { _mm256_sub_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_SSE
+        return { _mm_sub_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_NEON
+        return { vsubq_f32(a.value, b.value) };
+#else
+        return { a.value - b.value };
+#endif
+    }
+
+    friend SimdFloat operator*(SimdFloat a, SimdFloat b) noexcept
+    {
+#if SATGAIN_SIMD_AVX512
+        return { _mm512_mul_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_AVX
+        return { _mm256_mul_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_SSE
+        return { _mm_mul_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_NEON
+        return { vmulq_f32(a.value, b.value) };
+#else
+        return { a.value * b.value };
+#endif
+    }
+
+    friend SimdFloat operator/(SimdFloat a, SimdFloat b) noexcept
+    {
+#if SATGAIN_SIMD_AVX512
+        return { _mm512_div_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_AVX
+        return { _mm256_div_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_SSE
+        return { _mm_div_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+        return { vdivq_f32(a.value, b.value) };
+#elif SATGAIN_SIMD_NEON
+        auto reciprocal = vrecpeq_f32(b.value); // 32-bit NEON has no divide, refine the estimate twice
+        reciprocal = vmulq_f32(vrecpsq_f32(b.value, reciprocal), reciprocal);
+        reciprocal = vmulq_f32(vrecpsq_f32(b.value, reciprocal), reciprocal);
+        return { vmulq_f32(a.value, reciprocal) };
+#else
+        return { a.value / b.value };
+#endif
+    }
+
+    static SimdFloat min(SimdFloat a, SimdFloat b) noexcept
+    {
+#if SATGAIN_SIMD_AVX512
+        return { _mm512_min_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_AVX
+        return { _mm256_min_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_SSE
+        return { _mm_min_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_NEON
+        return { vminq_f32(a.value, b.value) };
+#else
+        return { std::min(a.value, b.value) };
+#endif
+    }
+
+    static SimdFloat max(SimdFloat a, SimdFloat b) noexcept
+    {
+#if SATGAIN_SIMD_AVX512
+        return { _mm512_max_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_AVX
+        return { _mm256_max_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_SSE
+        return { _mm_max_ps(a.value, b.value) };
+#elif SATGAIN_SIMD_NEON
+        return { vmaxq_f32(a.value, b.value) };
+#else
+        return { std::max(a.value, b.value) };
+#endif
+    }
+
+    static SimdFloat abs(SimdFloat a) noexcept
+    {
+#if SATGAIN_SIMD_AVX512
+        return { _mm512_abs_ps(a.value) };
+#elif SATGAIN_SIMD_AVX
+        return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.value) };
+#elif SATGAIN_SIMD_SSE
+        return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.value) };
+#elif SATGAIN_SIMD_NEON
+        return { vabsq_f32(a.value) };
+#else
+        return { std::abs(a.value) };
+#endif
+    }
+
+    // Magnitude of the first argument with the sign bit of the second
+    static SimdFloat copySign(SimdFloat magnitude, SimdFloat sign) noexcept
+    {
+#if SATGAIN_SIMD_AVX512
+        const auto signMask = _mm512_set1_epi32((int)0x80000000);
+        return { _mm512_castsi512_ps(_mm512_or_si512(_mm512_andnot_si512(signMask, _mm512_castps_si512(magnitude.value)),
+                                                     _mm512_and_si512(signMask, _mm512_castps_si512(sign.value)))) };
+#elif SATGAIN_SIMD_AVX
+        const auto signMask = _mm256_set1_ps(-0.0f);
+        return { _mm256_or_ps(_mm256_andnot_ps(signMask, magnitude.value), _mm256_and_ps(signMask, sign.value)) };
+#elif SATGAIN_SIMD_SSE
+        const auto signMask = _mm_set1_ps(-0.0f);
+        return { _mm_or_ps(_mm_andnot_ps(signMask, magnitude.value), _mm_and_ps(signMask, sign.value)) };
+#elif SATGAIN_SIMD_NEON
+        return { vbslq_f32(vdupq_n_u32(0x80000000u), sign.value, magnitude.value) };
+#else
+        return { std::copysign(magnitude.value, sign.value) };
+#endif
+    }
+
+    // Largest lane value
+    float reduceMax() const noexcept
+    {
+        alignas(64) float lanes[size];
+        store(lanes);
+
+        float result = lanes[0];
+        for (int i = 1; i < size; ++i)
+            result = std::max(result, lanes[i]);
+
+        return result;
+    }
+};
@@ -0,0 +1,182 @@
+#include "SpectrumAnalyzer.h"
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+    : juce::Thread("SatGain spectrum"),
+      window((size_t)fftSize),
+      history((size_t)fftSize, 0.0f),
+      fftData((size_t)(2 * fftSize), 0.0f)
+{
+    // Hann window, scaled by 2 / sum(window) so a full-scale sine peaks at 0 dB
+    for (int i = 0; i < fftSize; ++i)
+        window[(size_t)i] = 4.0f / fftSize * 0.5f * (1.0f - std::cos(juce::MathConstants<float>::twoPi * i / fftSize));
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    stop();
+}
+
+void SpectrumAnalyzer::start(AudioTelemetry& source)
+{
+    if (isThreadRunning())
+        return;
+
+    telemetry = &source;
+
+    std::fill(history.begin(), history.end(), 0.0f);
+    historyPosition = 0;
+    samplesUntilFrame = fftSize;
+    tableSampleRate = 0.0; // Rebuilds the column table and clears the smoothing on the first frame
+    lastOverruns = source.getSpectrumOverruns();
+
+    for (auto& slot : slots)
+        slot.numColumns = 0;
+
+    telemetry->setSpectrumEnabled(true);
+    startThread();
+}
+
+void SpectrumAnalyzer::stop()
+{
+    if (telemetry != nullptr)
+        telemetry->setSpectrumEnabled(false); // The audio thread stops pushing first
+
+    stopThread(2000);
+}
+
+void SpectrumAnalyzer::setNumColumns(int newNumColumns) noexcept
+{
+    requestedColumns.store(juce::jlimit(0, maxColumns, newNumColumns));
+}
+
+bool SpectrumAnalyzer::getColumns(std::vector<float>& dest)
+{
+    if ((middle.load(std::memory_order_acquire) & freshBit) != 0)
+        front = middle.exchange(front, std::memory_order_acq_rel) & 3;
+
+    const auto& columns = slots[(size_t)front];
+
+    if (columns.numColumns == 0 || columns.numColumns != (int)dest.size())
+        return false;
+
+    std::copy_n(columns.levels.begin(), columns.numColumns, dest.begin());
+    return true;
+}
+
+//==============================================================================
+void SpectrumAnalyzer::run()
+{
+    std::vector<float> incoming((size_t)fftSize);
+
+    while (! threadShouldExit())
+    {
+        // A dropped block leaves a gap in the stream. Everything queued may straddle it, so throw that
+        // away and wait for a whole window of fresh audio rather than transform across the splice.
+        const int overruns = telemetry->getSpectrumOverruns();
+
+        if (overruns != lastOverruns)
+        {
+            lastOverruns = overruns;
+            telemetry->discardSpectrum();
+            samplesUntilFrame = fftSize;
+        }
+
+        // Read up to the next frame boundary, so every frame sees exactly hopSize new samples
+        const int numRead = telemetry->popSpectrum(incoming.data(), samplesUntilFrame);
+
+        if (numRead == 0)
+        {
+            wait(10);
+            continue;
+        }
+
+        for (int i = 0; i < numRead; ++i)
+        {
+            history[(size_t)historyPosition] = incoming[(size_t)i];
+            historyPosition = (historyPosition + 1) % fftSize;
+        }
+
+        samplesUntilFrame -= numRead;
+
+        if (samplesUntilFrame == 0)
+        {
+            analyseFrame();
+            samplesUntilFrame = hopSize;
+        }
+    }
+}
+
+void SpectrumAnalyzer::analyseFrame()
+{
+    const double sampleRate = telemetry->getSampleRate();
+    const int numColumns = requestedColumns.load();
+
+    if (numColumns <= 0 || sampleRate <= 0.0)
+        return;
+
+    if (sampleRate != tableSampleRate || numColumns != (int)columnTable.size())
+        updateColumnTable(sampleRate, numColumns);
+
+    // Oldest sample first, windowed; the upper half is scratch for the transform
+    for (int i = 0; i < fftSize; ++i)
+        fftData[(size_t)i] = history[(size_t)((historyPosition + i) % fftSize)] * window[(size_t)i];
+
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    auto& columns = slots[(size_t)back];
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const auto& bins = columnTable[(size_t)column];
+        float magnitude;
+
+        if (bins.last > bins.first)
+            magnitude = *std::max_element(fftData.begin() + bins.first, fftData.begin() + bins.last + 1);
+        else
+            magnitude = fftData[(size_t)bins.first] + bins.fraction * (fftData[(size_t)bins.first + 1] - fftData[(size_t)bins.first]);
+
+        const float level = juce::Decibels::gainToDecibels(magnitude, floorDecibels);
+        auto& current = smoothed[(size_t)column];
+        current = level >= current ? level : current + releaseCoefficient * (level - current);
+        columns.levels[(size_t)column] = current;
+    }
+
+    columns.numColumns = numColumns;
+    back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & 3;
+}
+
+void SpectrumAnalyzer::updateColumnTable(double sampleRate, int numColumns)
+{
+    tableSampleRate = sampleRate;
+    columnTable.resize((size_t)numColumns);
+    smoothed.assign((size_t)numColumns, floorDecibels);
+    releaseCoefficient = (float)(1.0 - std::exp(-hopSize / (sampleRate * releaseSeconds)));
+
+    // Log-spaced columns from minimumFrequency up to the top of the audible range (or Nyquist)
+    const double binWidth = sampleRate / fftSize;
+    const double lowest = minimumFrequency;
+    const double highest = juce::jmin((double)maximumFrequency, 0.5 * sampleRate);
+    const double ratio = highest / lowest;
+    const int lastUsableBin = fftSize / 2 - 1;
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const double lowerBin = lowest * std::pow(ratio, (double)column / numColumns) / binWidth;
+        const double upperBin = lowest * std::pow(ratio, (double)(column + 1) / numColumns) / binWidth;
+        auto& bins = columnTable[(size_t)column];
+
+        bins.first = juce::jlimit(0, lastUsableBin, (int)std::ceil(lowerBin));
+        bins.last = juce::jlimit(0, lastUsableBin, (int)std::floor(upperBin));
+        bins.fraction = 0.0f;
+
+        // Narrower than a bin (the low end): interpolate at the column's centre frequency instead
+        if (bins.last <= bins.first)
+        {
+            const double centre = std::sqrt(lowerBin * upperBin);
+            bins.first = juce::jlimit(0, lastUsableBin - 1, (int)centre);
+            bins.last = bins.first;
+            bins.fraction = (float)juce::jlimit(0.0, 1.0, centre - bins.first);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioTelemetry.h"
+
+// Background FFT for the visualizer's spectrum view. The audio thread only copies a mono mix
+// into the telemetry's spectrum queue; this worker reads it, runs Hann-windowed FFT frames with
+// 75% overlap, maps the bins onto log-spaced display columns through a precomputed table and
+// smooths them. The GUI thread only copies out the latest finished column array.
+// While stopped there is no thread and the audio thread pushes nothing.
+class SpectrumAnalyzer : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 12;                 // 4096 points, ~12 Hz bins at 48 kHz
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 4;
+    static constexpr int maxColumns = 4096;
+    static constexpr float minimumFrequency = 20.0f;
+    static constexpr float maximumFrequency = 20000.0f;
+    static constexpr float floorDecibels = -100.0f;
+    static constexpr float releaseSeconds = 0.25f;      // Time constant of a falling column; rises are instant
+
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer() override;
+
+    // Message thread. start() is a no-op while running, stop() joins the worker.
+    void start(AudioTelemetry& source);
+    void stop();
+    bool isRunning() const { return isThreadRunning(); }
+
+    void setNumColumns(int newNumColumns) noexcept; // Display width, picked up by the worker on its next frame
+
+    // Copies the newest columns (dB, oldest frames already smoothed in) into dest.
+    // Returns false if nothing has been analysed yet at the current width.
+    bool getColumns(std::vector<float>& dest);
+
+private:
+    void run() override;
+    void analyseFrame();
+    void updateColumnTable(double sampleRate, int numColumns);
+
+    // Bins feeding one column: the loudest of [first, last] when the column spans several bins,
+    // otherwise a linear interpolation between first and first + 1
+    struct ColumnBins
+    {
+        int first = 0;
+        int last = 0;
+        float fraction = 0.0f;
+    };
+
+    // Finished frames go through a triple buffer: the worker fills one, the GUI reads another,
+    // and the third is swapped between them with one atomic exchange
+    struct Columns
+    {
+        std::vector<float> levels = std::vector<float>((size_t)maxColumns, floorDecibels);
+        int numColumns = 0;
+    };
+
+    AudioTelemetry* telemetry = nullptr;
+
+    juce::dsp::FFT fft{ fftOrder };
+    std::vector<float> window;       // Hann, scaled so a full-scale sine reads 0 dB
+    std::vector<float> history;      // Ring of the last fftSize samples
+    std::vector<float> fftData;      // 2 * fftSize, as performFrequencyOnlyForwardTransform wants
+    std::vector<float> smoothed;     // Per column, dB
+    std::vector<ColumnBins> columnTable;
+    int historyPosition = 0;
+    int samplesUntilFrame = fftSize;
+    int lastOverruns = 0; // AudioTelemetry's count when the window was last restarted
+    double tableSampleRate = 0.0;
+    float releaseCoefficient = 0.0f;
+
+    std::atomic<int> requestedColumns{ 0 };
+
+    static constexpr int freshBit = 4; // Set on the middle index when it holds a frame the GUI hasn't taken
+    std::array<Columns, 3> slots;
+    std::atomic<int> middle{ 1 };
+    int back = 0;  // Worker
+    int front = 2; // GUI
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzer)
+};
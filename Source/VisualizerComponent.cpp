@@ -2,42 +2,111 @@
 
 VisualizerComponent::VisualizerComponent()
 {
+    setOpaque(true);  // paint() fills the whole area, so the editor behind it isn't redrawn at 30 Hz
     startTimerHz(30); // Lower refresh rate to 30 Hz for better performance
 }
 
-void VisualizerComponent::pushSample(const float sample)
+VisualizerComponent::~VisualizerComponent()
 {
-    // Use a circular buffer to manage samples efficiently
-    if (writeIndex >= maxBufferSize)
-        writeIndex = 0; // Wrap around when reaching the end
+    analyzer.stop();
+}
+
+void VisualizerComponent::addBucket(const WaveformBucket& bucket)
+{
+    pyramid.addBucket(bucket);
+    hasData = true;
+}
+
+void VisualizerComponent::setSampleRate(double newSampleRate)
+{
+    if (newSampleRate > 0.0 && newSampleRate != sampleRate)
+    {
+        sampleRate = newSampleRate;
+        pyramid.reset(); // Old buckets would be drawn at the wrong time scale
+        hasData = false;
+    }
+}
+
+void VisualizerComponent::setTimeWindow(double seconds)
+{
+    timeWindowSeconds = juce::jlimit(0.01, 60.0, seconds);
+}
+
+void VisualizerComponent::setSpectrumSource(AudioTelemetry* source)
+{
+    if (source != spectrumSource)
+    {
+        analyzer.stop();
+        spectrumSource = source;
+    }
+
+    updateAnalyzer();
+}
+
+void VisualizerComponent::setView(View newView)
+{
+    view = newView;
+    updateAnalyzer();
+    repaint();
+}
 
-    audioBuffer.setSample(0, writeIndex, sample);
-    ++writeIndex;
+void VisualizerComponent::updateAnalyzer()
+{
+    if (view == View::spectrum && spectrumSource != nullptr)
+        analyzer.start(*spectrumSource);
+    else
+        analyzer.stop();
 }
 
 void VisualizerComponent::paint(juce::Graphics& g)
 {
     g.fillAll(juce::Colours::darkgrey); // Background color
 
-    auto width = getWidth();
-    auto height = getHeight();
+    if (view == View::spectrum)
+        paintSpectrum(g);
+    else
+        paintWaveform(g);
+}
+
+void VisualizerComponent::paintWaveform(juce::Graphics& g)
+{
+    if (! hasData || columns.empty())
+        return;
+
+    pyramid.render(timeWindowSeconds * sampleRate, columns.data(), (int)columns.size());
+
+    // Left channel in the top half, right channel in the bottom half
+    const float laneHeight = getHeight() / 2.0f;
+    g.setColour(juce::Colours::silver); // Waveform color
 
-    if (writeIndex > 0)
+    for (int channel = 0; channel < 2; ++channel)
     {
-        auto* buffer = audioBuffer.getReadPointer(0);
-        juce::Path waveformPath;
-        waveformPath.startNewSubPath(0, height / 2);
+        const float centre = laneHeight * (channel + 0.5f);
+        const float scale = laneHeight * 0.5f;
 
-        for (int i = 0; i < maxBufferSize; ++i)
+        for (int x = 0; x < (int)columns.size(); ++x)
         {
-            int bufferIndex = (writeIndex + i) % maxBufferSize; // Wrap around for circular buffer
-            float x = (float)i / (float)maxBufferSize * width;
-            float y = height / 2 - buffer[bufferIndex] * (height / 2);
-            waveformPath.lineTo(x, y);
+            const auto& column = columns[(size_t)x];
+            const float top = centre - juce::jlimit(-1.0f, 1.0f, column.maximum[channel]) * scale;
+            const float bottom = centre - juce::jlimit(-1.0f, 1.0f, column.minimum[channel]) * scale;
+            g.drawVerticalLine(x, top, juce::jmax(bottom, top + 1.0f)); // At least one pixel so silence still shows a line
         }
+    }
+}
+
+void VisualizerComponent::paintSpectrum(juce::Graphics& g)
+{
+    // The analyzer hands over finished columns; all that's left here is drawing them
+    if (spectrumColumns.empty() || ! analyzer.getColumns(spectrumColumns))
+        return;
+
+    const float height = (float)getHeight();
+    g.setColour(juce::Colours::silver);
 
-        g.setColour(juce::Colours::silver); // Waveform color
-        g.strokePath(waveformPath, juce::PathStrokeType(1.0f)); // Draw waveform
+    for (int x = 0; x < (int)spectrumColumns.size(); ++x)
+    {
+        const float level = juce::jmap(spectrumColumns[(size_t)x], SpectrumAnalyzer::floorDecibels, 0.0f, 0.0f, 1.0f);
+        g.drawVerticalLine(x, height * (1.0f - juce::jlimit(0.0f, 1.0f, level)), height);
     }
 }
 
@@ -48,10 +117,16 @@ void VisualizerComponent::timerCallback()
 
 void VisualizerComponent::resized()
 {
-    // Adjust buffer size or other parameters if needed
-}
-
-
-
+    columns.resize((size_t)juce::jmax(0, getWidth()));
 
+    const int numSpectrumColumns = juce::jmin(juce::jmax(0, getWidth()), SpectrumAnalyzer::maxColumns);
+    spectrumColumns.resize((size_t)numSpectrumColumns);
+    analyzer.setNumColumns(numSpectrumColumns);
+}
 
+void VisualizerComponent::mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel)
+{
+    // Scroll to zoom the time window (the spectrum view has nothing to zoom)
+    if (view == View::waveform)
+        setTimeWindow(timeWindowSeconds * std::pow(2.0, -wheel.deltaY * 4.0));
+}
@@ -1,31 +1,50 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "SpectrumAnalyzer.h"
+#include "WaveformPyramid.h"
 
 class VisualizerComponent : public juce::Component, private juce::Timer
 {
 public:
+    enum class View
+    {
+        waveform,
+        spectrum
+    };
+
     VisualizerComponent();
-    void pushSample(const float sample); // Push a single audio sample
+    ~VisualizerComponent() override;
+
+    void addBucket(const WaveformBucket& bucket); // Push one min/max bucket decimated on the audio thread
+    void setSampleRate(double newSampleRate);     // Clears the history if the rate changed
+    void setTimeWindow(double seconds);           // How much history to show, 10 ms to 60 s
+
+    // Where the spectrum view gets its audio; nullptr (the editor closing) stops the analyzer for good
+    void setSpectrumSource(AudioTelemetry* source);
+    void setView(View newView); // The analyzer thread only runs while the spectrum is shown
+    View getView() const noexcept { return view; }
+
     void paint(juce::Graphics& g) override;
     void resized() override;
+    void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
 
 private:
     void timerCallback() override;
+    void updateAnalyzer();
+    void paintWaveform(juce::Graphics& g);
+    void paintSpectrum(juce::Graphics& g);
 
-    juce::AudioBuffer<float> audioBuffer{ 1, 1024 }; // 1 channel, max size 1024
-    const int maxBufferSize = 1024;                  // Circular buffer size
-    int writeIndex = 0;                              // Write position in circular buffer
+    WaveformPyramid pyramid;                  // Multi-resolution history of both channels
+    std::vector<WaveformBucket> columns;      // One min/max pair per pixel column, sized in resized()
+    double sampleRate = 44100.0;
+    double timeWindowSeconds = 2.0;
+    bool hasData = false;
+
+    View view = View::waveform;
+    AudioTelemetry* spectrumSource = nullptr;
+    SpectrumAnalyzer analyzer;
+    std::vector<float> spectrumColumns; // dB per pixel column, sized in resized()
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VisualizerComponent)
 };
-
-
-
-
-
-
-
-
-
-
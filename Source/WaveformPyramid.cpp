@@ -0,0 +1,91 @@
+#include "WaveformPyramid.h"
+
+WaveformPyramid::WaveformPyramid()
+{
+    for (auto& level : levels)
+        level.ring.resize(levelCapacity);
+}
+
+void WaveformPyramid::reset()
+{
+    for (auto& level : levels)
+    {
+        level.numWritten = 0;
+        level.pendingCount = 0;
+    }
+}
+
+juce::int64 WaveformPyramid::getBucketSize(int level) noexcept
+{
+    juce::int64 size = baseBucketSize;
+    for (int i = 0; i < level; ++i)
+        size *= levelRatio;
+
+    return size;
+}
+
+void WaveformPyramid::addBucket(const WaveformBucket& bucket)
+{
+    auto incoming = bucket;
+
+    // Write into each level and carry a completed merge upwards, so the cost is amortised O(1)
+    for (int index = 0; index < numLevels; ++index)
+    {
+        auto& level = levels[(size_t)index];
+        level.ring[(size_t)(level.numWritten % levelCapacity)] = incoming;
+        ++level.numWritten;
+
+        if (level.pendingCount == 0)
+            level.pending = incoming;
+        else
+            level.pending.merge(incoming);
+
+        if (++level.pendingCount < levelRatio)
+            break;
+
+        incoming = level.pending;
+        level.pendingCount = 0;
+    }
+}
+
+void WaveformPyramid::render(double windowSamples, WaveformBucket* columns, int numColumns) const
+{
+    if (numColumns <= 0)
+        return;
+
+    // Coarsest level that still gives at least one bucket per column,
+    // then go coarser still if the window doesn't fit in that level's history
+    int levelIndex = 0;
+    while (levelIndex + 1 < numLevels && (double)getBucketSize(levelIndex + 1) * numColumns <= windowSamples)
+        ++levelIndex;
+
+    while (levelIndex + 1 < numLevels && windowSamples / (double)getBucketSize(levelIndex) > levelCapacity)
+        ++levelIndex;
+
+    const auto& level = levels[(size_t)levelIndex];
+    const double windowBuckets = windowSamples / (double)getBucketSize(levelIndex);
+    const double bucketsPerColumn = windowBuckets / numColumns;
+    const double firstPosition = (double)level.numWritten - windowBuckets;
+    const auto oldestAvailable = juce::jmax((juce::int64)0, level.numWritten - levelCapacity);
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        auto start = (juce::int64)std::floor(firstPosition + column * bucketsPerColumn);
+        auto end = juce::jmax(start + 1, (juce::int64)std::floor(firstPosition + (column + 1) * bucketsPerColumn));
+
+        start = juce::jmax(start, oldestAvailable);
+        end = juce::jmin(end, level.numWritten);
+
+        WaveformBucket result;
+
+        if (start < end)
+        {
+            result = level.ring[(size_t)(start % levelCapacity)];
+
+            for (auto index = start + 1; index < end; ++index)
+                result.merge(level.ring[(size_t)(index % levelCapacity)]);
+        }
+
+        columns[column] = result;
+    }
+}
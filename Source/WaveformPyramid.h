@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Min/max of a run of samples for the left and right channels
+struct WaveformBucket
+{
+    float minimum[2] = { 0.0f, 0.0f };
+    float maximum[2] = { 0.0f, 0.0f };
+
+    void merge(const WaveformBucket& other) noexcept
+    {
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            minimum[channel] = std::min(minimum[channel], other.minimum[channel]);
+            maximum[channel] = std::max(maximum[channel], other.maximum[channel]);
+        }
+    }
+};
+
+// Message-thread history of the waveform as min/max buckets at several resolutions.
+// Level 0 holds the buckets decimated on the audio thread (baseBucketSize samples each);
+// every level above merges levelRatio buckets of the one below. Rendering picks the
+// level whose bucket size is closest to one display column, so drawing any window
+// from a few milliseconds to a minute costs a handful of bucket reads per column.
+class WaveformPyramid
+{
+public:
+    static constexpr int baseBucketSize = 8;   // Samples per level-0 bucket
+    static constexpr int levelRatio = 4;       // Level n + 1 buckets cover this many level n buckets
+    static constexpr int numLevels = 6;        // Top level bucket = 8192 samples
+    static constexpr int levelCapacity = 4096; // Top level covers 4096 * 8192 samples, ~175 s at 192 kHz
+
+    WaveformPyramid();
+
+    void reset();
+    void addBucket(const WaveformBucket& bucket);
+
+    // Fills one bucket per display column with the last windowSamples samples, oldest first.
+    // Columns with no history yet come back as silence.
+    void render(double windowSamples, WaveformBucket* columns, int numColumns) const;
+
+private:
+    struct Level
+    {
+        std::vector<WaveformBucket> ring;
+        juce::int64 numWritten = 0;  // Total buckets ever written, ring index is this modulo levelCapacity
+        WaveformBucket pending;      // Partial bucket for the next level up
+        int pendingCount = 0;
+    };
+
+    static juce::int64 getBucketSize(int level) noexcept;
+
+    std::array<Level, numLevels> levels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPyramid)
+};
@@ -0,0 +1,839 @@
+/*
+  ==============================================================================
+
+    Headless micro-benchmark for GainKnobAudioProcessor::processBlock.
+
+    Built by ../CMakeLists.txt as SatGainBenchmark: a JUCE console app with the
+    files from ../../Source and ../../JuceLibraryCode on the header search path
+    (for JucePluginDefines.h). The editor is never created, it only has to link.
+
+    Usage: Benchmark [--quick]
+           Benchmark --update-golden <dir>   Render the reference outputs into <dir>
+           Benchmark --null-test <dir>       Check every processing path against them
+           Benchmark --self-test             Only the checks that need no goldens
+
+    The goldens live in Golden/ next to this file, with Manifest.txt recording the
+    signals, settings and tolerances they were rendered from. ctest runs the null test
+    against them once they're there, and the update-goldens target rewrites them after
+    an intended change; commit them with the change.
+
+    SatGainBenchmarkRealtime is the same program with SATGAIN_REALTIME_SANITIZER=1 (linked
+    with -ldl on Linux): any allocation, lock or blocking call inside processBlock is reported
+    with a stack trace, and either mode then exits with an error. See RealtimeSanitizer.h.
+
+    The null test renders a fixed set of signals (sines, a sweep, noise, impulses
+    and denormal-range input) through processBlock and compares each path with
+    the golden files, so faster kernels can be swapped in without changing the sound.
+    It also checks each saturation kernel against its definition and that the limiter
+    keeps a decaying over-ceiling burst under the ceiling at its longest lookahead.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/LookaheadLimiter.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/RealtimeSanitizer.h"
+#include "../../Source/SaturationKernel.h"
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+//==============================================================================
+namespace
+{
+    struct Setting
+    {
+        const char* name;
+        float gain;
+        float eqBoost;
+        int oversampling = 0;       // Index into 1x/2x/4x/8x
+        int oversamplingFilter = 0; // 0 = polyphase IIR, 1 = linear-phase FIR
+        int saturationCurve = 0;    // Index into SaturationKernel::Curve
+        int bands = 0;              // Index, so one less than the number of bands
+        int autoGain = 0;           // 1 = makeup gain on
+        int limiter = 0;            // 1 = output limiter on, default lookahead
+    };
+
+    // Gain values either side of 1.0 so both the clean and saturating paths are covered
+    const Setting settings[] =
+    {
+        { "clean",      0.5f,  0.0f },
+        { "unity",      1.0f,  0.0f },
+        { "drive",      4.0f,  0.0f },
+        { "drive+eq",   4.0f,  6.0f },
+        { "max",        10.0f, 10.0f },
+        { "drive+agc",  4.0f,  6.0f, 0, 0, 0, 0, 1 },
+        { "drive+lim",  4.0f,  6.0f, 0, 0, 0, 0, 0, 1 }
+    };
+
+    // Cost of each oversampling factor and filter type around the drive setting
+    const Setting oversamplingSettings[] =
+    {
+        { "os1x",      4.0f, 0.0f, 0, 0 },
+        { "os2x-iir",  4.0f, 0.0f, 1, 0 },
+        { "os4x-iir",  4.0f, 0.0f, 2, 0 },
+        { "os8x-iir",  4.0f, 0.0f, 3, 0 },
+        { "os2x-fir",  4.0f, 0.0f, 1, 1 },
+        { "os4x-fir",  4.0f, 0.0f, 2, 1 },
+        { "os8x-fir",  4.0f, 0.0f, 3, 1 }
+    };
+
+    // Cost of each waveshaping curve at the drive setting
+    const Setting curveSettings[] =
+    {
+        { "soft",  4.0f, 0.0f, 0, 0, 0 },
+        { "tanh",  4.0f, 0.0f, 0, 0, 1 },
+        { "tube",  4.0f, 0.0f, 0, 0, 2 },
+        { "clip",  4.0f, 0.0f, 0, 0, 3 }
+    };
+
+    // Cost of splitting the saturation into bands, at 1x and 4x
+    const Setting bandSettings[] =
+    {
+        { "bands1",     4.0f, 0.0f, 0, 0, 0, 0 },
+        { "bands2",     4.0f, 0.0f, 0, 0, 0, 1 },
+        { "bands3",     4.0f, 0.0f, 0, 0, 0, 2 },
+        { "bands4",     4.0f, 0.0f, 0, 0, 0, 3 },
+        { "bands4-os4", 4.0f, 0.0f, 2, 0, 0, 3 }
+    };
+
+    const double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    const int blockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const int oversamplingBlockSizes[] = { 64, 512 };
+
+    // Mono, stereo, 5.1, 7.1.4, 3rd-order ambisonics, 7th-order ambisonics
+    const int channelCounts[] = { 1, 2, 6, 12, 16, 64 };
+
+    uint64_t readCycleCounter()
+    {
+#if JUCE_INTEL
+        return (uint64_t) __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    void setParameter(GainKnobAudioProcessor& processor, Parameters::ID id, float value)
+    {
+        if (auto* param = processor.parameters.getParameter(Parameters::getParamID(id)))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    struct Result
+    {
+        double nsPerSample = 0.0;
+        double cyclesPerSample = 0.0;
+        double percentOfBudget = 0.0;
+        double worstBlockPercent = 0.0;
+        int latencySamples = 0;
+    };
+
+    void printHeader()
+    {
+        std::cout << juce::String::formatted("%-10s %9s %6s %10s %12s %10s %10s %8s",
+                                             "setting", "rate", "block", "ns/sample", "cycles/smpl", "% budget", "worst %", "latency") << std::endl;
+    }
+
+    void printResult(const Setting& setting, double sampleRate, int blockSize, const Result& result)
+    {
+        std::cout << juce::String::formatted("%-10s %9.0f %6d %10.2f %12.2f %10.3f %10.3f %8d",
+                                             setting.name, sampleRate, blockSize,
+                                             result.nsPerSample, result.cyclesPerSample,
+                                             result.percentOfBudget, result.worstBlockPercent,
+                                             result.latencySamples) << std::endl;
+    }
+
+    Result runCase(double sampleRate, int blockSize, const Setting& setting, double secondsOfAudio, int numChannels = 2,
+                   bool silentInput = false, bool automatedGain = false)
+    {
+
+        GainKnobAudioProcessor processor;
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        setParameter(processor, Parameters::ID::gain, setting.gain);
+        setParameter(processor, Parameters::ID::eqBoost, setting.eqBoost);
+        setParameter(processor, Parameters::ID::oversampling, (float)setting.oversampling);
+        setParameter(processor, Parameters::ID::oversamplingFilter, (float)setting.oversamplingFilter);
+        setParameter(processor, Parameters::ID::saturationCurve, (float)setting.saturationCurve);
+        setParameter(processor, Parameters::ID::bands, (float)setting.bands);
+        setParameter(processor, Parameters::ID::autoGain, (float)setting.autoGain);
+        setParameter(processor, Parameters::ID::limiter, (float)setting.limiter);
+
+        // Source material: a 220 Hz sine with a little noise, refilled before every call
+        // so the in-place processing never feeds back into itself
+        juce::AudioBuffer<float> source(numChannels, blockSize);
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1234);
+
+        source.clear();
+
+        for (int channel = 0; channel < numChannels && ! silentInput; ++channel)
+            for (int i = 0; i < blockSize; ++i)
+                source.setSample(channel, i, 0.5f * std::sin(juce::MathConstants<float>::twoPi * 220.0f * (float)i / (float)sampleRate)
+                                                 + 0.05f * (random.nextFloat() * 2.0f - 1.0f));
+
+        int blockIndex = 0;
+
+        auto runBlock = [&]()
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                buffer.copyFrom(channel, 0, source, channel, 0, blockSize);
+
+            // A new gain every block keeps the ramp running the whole time (set outside the timed call)
+            if (automatedGain)
+                setParameter(processor, Parameters::ID::gain, blockIndex % 2 == 0 ? setting.gain : 0.5f * setting.gain);
+
+            ++blockIndex;
+
+            auto startTicks = juce::Time::getHighResolutionTicks();
+            auto startCycles = readCycleCounter();
+            processor.processBlock(buffer, midi);
+            auto endCycles = readCycleCounter();
+            auto endTicks = juce::Time::getHighResolutionTicks();
+
+            return std::make_pair(endTicks - startTicks, endCycles - startCycles);
+        };
+
+        // Warm up caches, branch predictors and the coefficient update
+        for (int i = 0; i < 64; ++i)
+            runBlock();
+
+        const int numBlocks = juce::jmax(64, (int)(secondsOfAudio * sampleRate / blockSize));
+        const double ticksPerSecond = (double)juce::Time::getHighResolutionTicksPerSecond();
+        const double blockBudgetSeconds = blockSize / sampleRate;
+
+        juce::int64 totalTicks = 0;
+        uint64_t totalCycles = 0;
+        juce::int64 worstTicks = 0;
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            auto [ticks, cycles] = runBlock();
+            totalTicks += ticks;
+            totalCycles += cycles;
+            worstTicks = juce::jmax(worstTicks, ticks);
+        }
+
+        processor.releaseResources();
+
+        const double totalSamples = (double)numBlocks * blockSize;
+        const double totalSeconds = (double)totalTicks / ticksPerSecond;
+
+        Result result;
+        result.latencySamples = processor.getLatencySamples();
+        result.nsPerSample = totalSeconds * 1.0e9 / totalSamples;
+
+        if (totalCycles > 0)
+            result.cyclesPerSample = (double)totalCycles / totalSamples;
+        else
+            result.cyclesPerSample = result.nsPerSample * juce::SystemStats::getCpuSpeedInMegahertz() / 1000.0; // Estimate when there's no cycle counter
+
+        result.percentOfBudget = 100.0 * totalSeconds / (numBlocks * blockBudgetSeconds);
+        result.worstBlockPercent = 100.0 * ((double)worstTicks / ticksPerSecond) / blockBudgetSeconds;
+        return result;
+    }
+
+    //==============================================================================
+    // Null test: golden outputs for a few reference signals, and a tolerance per processing path
+    constexpr double nullTestSampleRate = 48000.0;
+    constexpr int nullTestLength = 24000; // Half a second per signal
+    constexpr float nullTestAmplitude = 0.5f;
+
+    struct ReferenceSignal
+    {
+        const char* name;
+        std::function<void(juce::AudioBuffer<float>&)> fill;
+    };
+
+    const ReferenceSignal referenceSignals[] =
+    {
+        { "sine", [](juce::AudioBuffer<float>& buffer)
+            {
+                // 1 kHz left, 100 Hz right so the channels aren't identical
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    const float t = (float)(i / nullTestSampleRate);
+                    buffer.setSample(0, i, nullTestAmplitude * std::sin(juce::MathConstants<float>::twoPi * 1000.0f * t));
+                    buffer.setSample(1, i, nullTestAmplitude * std::sin(juce::MathConstants<float>::twoPi * 100.0f * t));
+                }
+            } },
+        { "sweep", [](juce::AudioBuffer<float>& buffer)
+            {
+                // Exponential 20 Hz - 20 kHz, phase accumulated in double so it stays stable
+                const double duration = buffer.getNumSamples() / nullTestSampleRate;
+                const double ratio = std::log(20000.0 / 20.0);
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    const double t = i / nullTestSampleRate;
+                    const double phase = juce::MathConstants<double>::twoPi * 20.0 * duration / ratio * (std::exp(t * ratio / duration) - 1.0);
+
+                    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                        buffer.setSample(channel, i, nullTestAmplitude * (float)std::sin(phase));
+                }
+            } },
+        { "noise", [](juce::AudioBuffer<float>& buffer)
+            {
+                juce::Random random(0x5a7);
+
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        buffer.setSample(channel, i, nullTestAmplitude * (random.nextFloat() * 2.0f - 1.0f));
+            } },
+        { "impulses", [](juce::AudioBuffer<float>& buffer)
+            {
+                // Full-scale clicks every 100 ms, alternating polarity
+                buffer.clear();
+
+                for (int i = 0, n = 0; i < buffer.getNumSamples(); i += (int)(nullTestSampleRate / 10.0), ++n)
+                    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                        buffer.setSample(channel, i, n % 2 == 0 ? 1.0f : -1.0f);
+            } },
+        { "denormal", [](juce::AudioBuffer<float>& buffer)
+            {
+                // Noise around 1e-39, below the smallest normal float
+                juce::Random random(0xd3a);
+
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        buffer.setSample(channel, i, 1.0e-39f * (random.nextFloat() * 2.0f - 1.0f));
+            } }
+    };
+
+    // Every processing mode the output depends on
+    const Setting nullTestSettings[] =
+    {
+        { "clean",     0.5f,  0.0f },
+        { "drive",     4.0f,  0.0f },
+        { "drive+eq",  4.0f,  6.0f },
+        { "max",       10.0f, 10.0f },
+        { "os4x-iir",  4.0f,  6.0f, 2, 0 },
+        { "os2x-fir",  4.0f,  6.0f, 1, 1 },
+        { "tanh",      4.0f,  6.0f, 0, 0, 1 },
+        { "tube",      4.0f,  6.0f, 0, 0, 2 },
+        { "clip",      4.0f,  6.0f, 0, 0, 3 },
+        { "bands3",    4.0f,  6.0f, 0, 0, 1, 2 },
+        { "bands4-os", 4.0f,  6.0f, 1, 0, 0, 3 },
+        { "agc",       4.0f,  6.0f, 0, 0, 0, 0, 1 },
+        { "limiter",   10.0f, 10.0f, 0, 0, 3, 0, 0, 1 }
+    };
+
+    // Renders a reference signal with a given setting; alternative kernels go in as new paths
+    using RenderPath = std::function<void(juce::AudioBuffer<float>&, const Setting&)>;
+
+    void renderWithBlockSizes(juce::AudioBuffer<float>& buffer, const Setting& setting, const std::vector<int>& blockSizes)
+    {
+        const int maxBlockSize = *std::max_element(blockSizes.begin(), blockSizes.end());
+
+        GainKnobAudioProcessor processor;
+        processor.setPlayConfigDetails(buffer.getNumChannels(), buffer.getNumChannels(), nullTestSampleRate, maxBlockSize);
+
+        // Set before prepareToPlay so every path starts from settled smoothers
+        setParameter(processor, Parameters::ID::gain, setting.gain);
+        setParameter(processor, Parameters::ID::eqBoost, setting.eqBoost);
+        setParameter(processor, Parameters::ID::oversampling, (float)setting.oversampling);
+        setParameter(processor, Parameters::ID::oversamplingFilter, (float)setting.oversamplingFilter);
+        setParameter(processor, Parameters::ID::saturationCurve, (float)setting.saturationCurve);
+        setParameter(processor, Parameters::ID::bands, (float)setting.bands);
+        setParameter(processor, Parameters::ID::autoGain, (float)setting.autoGain);
+        setParameter(processor, Parameters::ID::limiter, (float)setting.limiter);
+        processor.prepareToPlay(nullTestSampleRate, maxBlockSize);
+
+        juce::MidiBuffer midi;
+
+        for (int start = 0, index = 0; start < buffer.getNumSamples(); ++index)
+        {
+            const int numSamples = juce::jmin(blockSizes[(size_t)index % blockSizes.size()], buffer.getNumSamples() - start);
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, numSamples);
+            processor.processBlock(block, midi);
+            start += numSamples;
+        }
+
+        processor.releaseResources();
+    }
+
+    struct NullTestPath
+    {
+        const char* name;
+        double toleranceDecibels; // Largest allowed difference from the golden output, in dBFS (-inf = bit-exact)
+        RenderPath render;
+    };
+
+    const NullTestPath nullTestPaths[] =
+    {
+        // Goldens may come from a machine with a different SIMD width, which is worth a few ulps
+        { "processBlock/512", -120.0, [](juce::AudioBuffer<float>& buffer, const Setting& setting)
+            {
+                renderWithBlockSizes(buffer, setting, { 512 });
+            } },
+
+        // Host-style odd and changing block sizes must not change the result
+        { "processBlock/mixed", -120.0, [](juce::AudioBuffer<float>& buffer, const Setting& setting)
+            {
+                renderWithBlockSizes(buffer, setting, { 1, 37, 512, 7, 128, 1000, 3 });
+            } }
+    };
+
+    // Each saturation curve as processBlock runs it against its definition, sample by sample.
+    // These don't need goldens: the reference function is the definition of the curve.
+    struct KernelCheck
+    {
+        const char* name;
+        double toleranceDecibels;
+        void (*process)(float*, int, float) noexcept;
+        void (*processRamp)(float*, int, float, float) noexcept;
+        float (*reference)(float);
+    };
+
+    const KernelCheck kernelChecks[] =
+    {
+        // 1 ulp at full scale is about -138 dB
+        { "softKnee/vector", -130.0, SaturationKernel::process<SaturationKernel::SoftKnee>, SaturationKernel::process<SaturationKernel::SoftKnee>,
+          [](float x) { return SaturationKernel::SoftKnee::processSample(x); } },
+        { "hardClip/vector", -std::numeric_limits<double>::infinity(), SaturationKernel::process<SaturationKernel::HardClip>, SaturationKernel::process<SaturationKernel::HardClip>,
+          [](float x) { return juce::jlimit(-1.0f, 1.0f, x); } },
+
+        // Tabulated curves against their closed forms in double
+        { "tanh/table", -115.0, SaturationKernel::process<SaturationKernel::Tanh>, SaturationKernel::process<SaturationKernel::Tanh>,
+          [](float x) { return (float)std::tanh((double)x); } },
+        { "tube/table", -115.0, SaturationKernel::process<SaturationKernel::Tube>, SaturationKernel::process<SaturationKernel::Tube>,
+          [](float x) { return (float)SaturationKernel::Tube::evaluate((double)x); } }
+    };
+
+    // A ramp when the two gains differ, checked against the per-sample gain it's defined to apply
+    float kernelDeviation(const juce::AudioBuffer<float>& input, float startGain, float endGain, const KernelCheck& check)
+    {
+        juce::AudioBuffer<float> processed(input);
+        const int numSamples = input.getNumSamples();
+        const float step = (endGain - startGain) / (float)numSamples;
+        float largest = 0.0f;
+
+        for (int channel = 0; channel < input.getNumChannels(); ++channel)
+        {
+            if (startGain == endGain)
+                check.process(processed.getWritePointer(channel), numSamples, endGain);
+            else
+                check.processRamp(processed.getWritePointer(channel), numSamples, startGain, endGain);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float gain = startGain == endGain ? endGain : startGain + ((float)i + 1.0f) * step;
+                const float driven = input.getSample(channel, i) * gain;
+                const float reference = gain > 1.0f ? check.reference(driven) : driven;
+                largest = juce::jmax(largest, std::abs(processed.getSample(channel, i) - reference));
+            }
+        }
+
+        return largest;
+    }
+
+    // Loudest output of the limiter at its longest lookahead for a burst that decays sample by sample.
+    // Each sample then needs a little less reduction than the one before, so none is dropped from
+    // the back of the gain deque and it holds the whole window.
+    float limiterPeak(float burstPeak, int blockSize)
+    {
+        LookaheadLimiter limiter;
+        limiter.prepare(nullTestSampleRate, 2);
+        limiter.setLookaheadMs(LookaheadLimiter::maximumLookaheadMs);
+
+        juce::AudioBuffer<float> buffer(2, nullTestLength);
+        buffer.clear();
+
+        for (int i = 0; i < nullTestLength / 2; ++i)
+        {
+            const float level = burstPeak * (float)std::exp(-i / (0.05 * nullTestSampleRate));
+            buffer.setSample(0, i, i % 2 == 0 ? level : -level);
+            buffer.setSample(1, i, level * 0.5f);
+        }
+
+        juce::dsp::AudioBlock<float> block(buffer);
+
+        for (int start = 0; start < nullTestLength; start += blockSize)
+            limiter.process(block.getSubBlock((size_t)start, (size_t)juce::jmin(blockSize, nullTestLength - start)));
+
+        return buffer.getMagnitude(0, nullTestLength);
+    }
+
+    juce::File getGoldenFile(const juce::File& directory, const ReferenceSignal& signal, const Setting& setting)
+    {
+        return directory.getChildFile(juce::String(signal.name) + "_" + juce::String(setting.name).replace("+", "-") + ".wav");
+    }
+
+    // Goldens are 32-bit float WAVs, so they hold the output exactly and can be opened in any editor
+    bool writeGolden(const juce::File& file, const juce::AudioBuffer<float>& buffer)
+    {
+        file.deleteFile();
+
+        juce::WavAudioFormat wav;
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+
+        if (! stream->openedOk())
+            return false;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), nullTestSampleRate,
+                                                                            (unsigned int)buffer.getNumChannels(), 32, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    bool readGolden(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+
+        if (reader == nullptr || reader->lengthInSamples != nullTestLength || (int)reader->numChannels != buffer.getNumChannels())
+            return false;
+
+        return reader->read(&buffer, 0, nullTestLength, 0, true, true);
+    }
+
+    juce::String formatDecibels(float difference)
+    {
+        return difference == 0.0f ? juce::String("bit-exact")
+                                  : juce::String(juce::Decibels::gainToDecibels(difference, -400.0f), 1) + " dB";
+    }
+
+    // One line per check, ok or FAIL, with the largest difference found
+    bool reportCheck(float difference, double toleranceDecibels, const juce::String& label)
+    {
+        const bool passed = difference == 0.0f || juce::Decibels::gainToDecibels(difference, -400.0f) <= toleranceDecibels;
+        std::cout << juce::String::formatted("%-5s ", passed ? "ok" : "FAIL") << label << formatDecibels(difference) << std::endl;
+        return passed;
+    }
+
+    float largestDifference(const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference)
+    {
+        float difference = 0.0f;
+
+        for (int channel = 0; channel < output.getNumChannels(); ++channel)
+            for (int i = 0; i < output.getNumSamples(); ++i)
+                difference = juce::jmax(difference, std::abs(output.getSample(channel, i) - reference.getSample(channel, i)));
+
+        return difference;
+    }
+
+    int runKernelChecks(const juce::AudioBuffer<float>& input, const ReferenceSignal& signal)
+    {
+        int numFailures = 0;
+
+        for (auto& check : kernelChecks)
+        {
+            // Fixed gains, then ramps across 1 both ways, as automation produces them
+            const std::pair<float, float> gains[] = { { 0.5f, 0.5f }, { 4.0f, 4.0f }, { 10.0f, 10.0f }, { 0.5f, 10.0f }, { 10.0f, 0.5f } };
+
+            for (auto [startGain, endGain] : gains)
+            {
+                const auto gainLabel = startGain == endGain ? juce::String(endGain, 1) : juce::String(startGain, 1) + ">" + juce::String(endGain, 1);
+                const auto label = juce::String::formatted("%-10s gain %-9s %-20s ", signal.name, gainLabel.toRawUTF8(), check.name);
+                numFailures += reportCheck(kernelDeviation(input, startGain, endGain, check), check.toleranceDecibels, label) ? 0 : 1;
+            }
+        }
+
+        return numFailures;
+    }
+
+    int runLimiterChecks()
+    {
+        int numFailures = 0;
+
+        for (float burstPeak : { 1.5f, 4.0f, 30.0f })
+        {
+            for (int blockSize : { 1, 512 })
+            {
+                const float peak = limiterPeak(burstPeak, blockSize);
+                const bool passed = peak <= LookaheadLimiter::ceiling;
+                numFailures += passed ? 0 : 1;
+
+                std::cout << juce::String::formatted("%-5s burst %-4.1f block %-4d limiter/ceiling      ", passed ? "ok" : "FAIL", burstPeak, blockSize)
+                          << juce::String(peak, 7) << std::endl;
+            }
+        }
+
+        return numFailures;
+    }
+
+    // What the goldens were rendered from: each signal with a hash of the samples it produces,
+    // each setting, each path with its tolerance. --update-golden stores it next to the WAVs and
+    // the null test refuses goldens made from anything else.
+    const char* const manifestName = "Manifest.txt";
+
+    juce::uint64 hashSamples(const juce::AudioBuffer<float>& buffer)
+    {
+        juce::uint64 hash = 14695981039346656037ull; // 64-bit FNV-1a over the sample bits
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                const float sample = buffer.getSample(channel, i);
+                juce::uint32 bits;
+                std::memcpy(&bits, &sample, sizeof(bits));
+                hash = (hash ^ bits) * 1099511628211ull;
+            }
+        }
+
+        return hash;
+    }
+
+    juce::String describeNullTest()
+    {
+        juce::String text = "# SatGain null-test goldens, written by --update-golden. Re-render them whenever this changes.\n";
+        text << juce::String::formatted("rate %.0f length %d channels 2\n", nullTestSampleRate, nullTestLength);
+
+        for (auto& signal : referenceSignals)
+        {
+            juce::AudioBuffer<float> input(2, nullTestLength);
+            signal.fill(input);
+            text << "signal " << signal.name << " " << juce::String::toHexString((juce::int64)hashSamples(input)) << "\n";
+        }
+
+        for (auto& setting : nullTestSettings)
+            text << juce::String::formatted("setting %s gain %g eq %g os %d filter %d curve %d bands %d agc %d limiter %d\n",
+                                            setting.name, setting.gain, setting.eqBoost, setting.oversampling, setting.oversamplingFilter,
+                                            setting.saturationCurve, setting.bands, setting.autoGain, setting.limiter);
+
+        for (auto& path : nullTestPaths)
+            text << juce::String::formatted("path %s tolerance %.1f dB\n", path.name, path.toleranceDecibels);
+
+        return text;
+    }
+
+    int runNullTest(const juce::File& directory, bool updateGolden)
+    {
+        int numFailures = 0;
+
+        if (! updateGolden)
+        {
+            if (directory.findChildFiles(juce::File::findFiles, false, "*.wav").isEmpty())
+            {
+                std::cout << "FAIL  no goldens in " << directory.getFullPathName()
+                          << ": render them from a known-good build with --update-golden (the update-goldens target)" << std::endl;
+                return 1;
+            }
+
+            const auto manifest = directory.getChildFile(manifestName);
+
+            if (manifest.loadFileAsString().replace("\r\n", "\n") != describeNullTest())
+            {
+                std::cout << "FAIL  " << manifest.getFullPathName() << " is missing or doesn't match the signals, settings and paths"
+                          << " in this build: re-render the goldens (the update-goldens target)" << std::endl;
+                return 1;
+            }
+        }
+
+        for (auto& signal : referenceSignals)
+        {
+            juce::AudioBuffer<float> input(2, nullTestLength);
+            signal.fill(input);
+
+            for (auto& setting : nullTestSettings)
+            {
+                const auto goldenFile = getGoldenFile(directory, signal, setting);
+
+                if (updateGolden)
+                {
+                    juce::AudioBuffer<float> output(input);
+                    nullTestPaths[0].render(output, setting);
+
+                    if (! writeGolden(goldenFile, output))
+                    {
+                        std::cerr << "Error: can't write " << goldenFile.getFullPathName() << std::endl;
+                        return 1;
+                    }
+
+                    continue;
+                }
+
+                juce::AudioBuffer<float> golden(2, nullTestLength);
+                if (! readGolden(goldenFile, golden))
+                {
+                    std::cout << "FAIL  missing or mismatched golden " << goldenFile.getFileName() << std::endl;
+                    ++numFailures;
+                    continue;
+                }
+
+                for (auto& path : nullTestPaths)
+                {
+                    juce::AudioBuffer<float> output(input);
+                    path.render(output, setting);
+
+                    const auto label = juce::String::formatted("%-10s %-10s %-20s ", signal.name, setting.name, path.name);
+                    numFailures += reportCheck(largestDifference(output, golden), path.toleranceDecibels, label) ? 0 : 1;
+                }
+            }
+
+            if (! updateGolden)
+                numFailures += runKernelChecks(input, signal);
+        }
+
+        if (updateGolden)
+        {
+            const auto manifest = directory.getChildFile(manifestName);
+
+            if (! manifest.replaceWithText(describeNullTest(), false, false, "\n"))
+            {
+                std::cerr << "Error: can't write " << manifest.getFullPathName() << std::endl;
+                return 1;
+            }
+
+            std::cout << "Wrote golden outputs to " << directory.getFullPathName() << std::endl;
+            return 0;
+        }
+
+        numFailures += runLimiterChecks();
+
+        std::cout << (numFailures == 0 ? "All paths match the golden outputs" : juce::String(numFailures) + " check(s) failed") << std::endl;
+        return numFailures == 0 ? 0 : 1;
+    }
+
+    // The checks that need no goldens: every path against the first one, rendered side by side,
+    // the kernels against their definitions and the limiter against its ceiling. Catches a path
+    // that depends on the block size, not a change to the sound; that's the null test's job.
+    int runSelfTest()
+    {
+        int numFailures = 0;
+
+        for (auto& signal : referenceSignals)
+        {
+            juce::AudioBuffer<float> input(2, nullTestLength);
+            signal.fill(input);
+
+            for (auto& setting : nullTestSettings)
+            {
+                juce::AudioBuffer<float> reference(input);
+                nullTestPaths[0].render(reference, setting);
+
+                for (size_t index = 1; index < std::size(nullTestPaths); ++index)
+                {
+                    auto& path = nullTestPaths[index];
+                    juce::AudioBuffer<float> output(input);
+                    path.render(output, setting);
+
+                    const auto label = juce::String::formatted("%-10s %-10s %-20s ", signal.name, setting.name, path.name);
+                    numFailures += reportCheck(largestDifference(output, reference), path.toleranceDecibels, label) ? 0 : 1;
+                }
+            }
+
+            numFailures += runKernelChecks(input, signal);
+        }
+
+        numFailures += runLimiterChecks();
+
+        std::cout << (numFailures == 0 ? "All self checks passed" : juce::String(numFailures) + " check(s) failed") << std::endl;
+        return numFailures == 0 ? 0 : 1;
+    }
+
+    // Non-zero when a sanitizer build caught processBlock allocating, locking or blocking
+    int reportRealtimeViolations()
+    {
+        const int numViolations = RealtimeSanitizer::getNumViolations();
+
+        if (numViolations == 0)
+            return 0;
+
+        std::cerr << numViolations << " real-time violation(s) inside processBlock, see the stack traces above" << std::endl;
+        return 1;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser; // The parameter tree needs the message manager to exist
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    if (args.contains("--self-test"))
+        return juce::jmax(runSelfTest(), reportRealtimeViolations());
+
+    for (auto mode : { "--null-test", "--update-golden" })
+    {
+        const int index = args.indexOf(mode);
+
+        if (index >= 0 && index + 1 < args.size())
+        {
+            auto directory = juce::File::getCurrentWorkingDirectory().getChildFile(args[index + 1]);
+            directory.createDirectory();
+            const int result = runNullTest(directory, juce::String(mode) == "--update-golden");
+            return juce::jmax(result, reportRealtimeViolations());
+        }
+    }
+
+    const double secondsOfAudio = args.contains("--quick") ? 0.5 : 5.0;
+
+    std::cout << "SatGain processBlock benchmark (stereo, ns and cycles per sample frame)" << std::endl;
+    printHeader();
+
+    for (auto& setting : settings)
+        for (auto sampleRate : sampleRates)
+            for (auto blockSize : blockSizes)
+                printResult(setting, sampleRate, blockSize, runCase(sampleRate, blockSize, setting, secondsOfAudio));
+
+    std::cout << std::endl << "Oversampling cost (gain 4.0, latency in host-rate samples)" << std::endl;
+    printHeader();
+
+    for (auto& setting : oversamplingSettings)
+        for (auto sampleRate : sampleRates)
+            for (auto blockSize : oversamplingBlockSizes)
+                printResult(setting, sampleRate, blockSize, runCase(sampleRate, blockSize, setting, secondsOfAudio));
+
+    std::cout << std::endl << "Saturation curves (gain 4.0, no oversampling)" << std::endl;
+    printHeader();
+
+    for (auto& setting : curveSettings)
+        for (auto sampleRate : sampleRates)
+            for (auto blockSize : oversamplingBlockSizes)
+                printResult(setting, sampleRate, blockSize, runCase(sampleRate, blockSize, setting, secondsOfAudio));
+
+    std::cout << std::endl << "Multiband saturation (gain 4.0, soft knee)" << std::endl;
+    printHeader();
+
+    for (auto& setting : bandSettings)
+        for (auto sampleRate : sampleRates)
+            for (auto blockSize : oversamplingBlockSizes)
+                printResult(setting, sampleRate, blockSize, runCase(sampleRate, blockSize, setting, secondsOfAudio));
+
+    std::cout << std::endl << "Idle instances (silent input, after the tail has rung out)" << std::endl;
+    printHeader();
+
+    for (auto* setting : { &settings[3], &oversamplingSettings[2], &bandSettings[3], &settings[6] })
+        for (auto blockSize : oversamplingBlockSizes)
+            printResult(*setting, 48000.0, blockSize, runCase(48000.0, blockSize, *setting, secondsOfAudio, 2, true));
+
+    std::cout << std::endl << "Gain automation (a new gain every block, so always ramping; compare with the steady rows above)" << std::endl;
+    printHeader();
+
+    for (auto* setting : { &settings[3], &oversamplingSettings[2], &bandSettings[3] })
+        for (auto blockSize : oversamplingBlockSizes)
+            printResult(*setting, 48000.0, blockSize, runCase(48000.0, blockSize, *setting, secondsOfAudio, 2, false, true));
+
+    std::cout << std::endl << "Channel scaling (drive+eq, 48 kHz, 512 samples)" << std::endl;
+    std::cout << juce::String::formatted("%8s %12s %14s %10s", "channels", "ns/frame", "ns/chan-sample", "% budget") << std::endl;
+
+    for (auto numChannels : channelCounts)
+    {
+        auto result = runCase(48000.0, 512, settings[3], secondsOfAudio, numChannels);
+
+        std::cout << juce::String::formatted("%8d %12.2f %14.3f %10.3f",
+                                             numChannels, result.nsPerSample, result.nsPerSample / numChannels,
+                                             result.percentOfBudget) << std::endl;
+    }
+
+    return reportRealtimeViolations();
+}
@@ -0,0 +1,574 @@
+/*
+  ==============================================================================
+
+    Offline batch renderer: runs WAV/AIFF files through the exact SatGain DSP
+    without a host.
+
+    Built by ../CMakeLists.txt as SatGainRender: a JUCE console app with the
+    files from ../../Source and ../../JuceLibraryCode on the header search path
+    (for JucePluginDefines.h).
+
+    Usage: SatGainRender [options] <input files...>
+
+        --out <dir>              Where to write the results (default: next to each input)
+        --jobs <n>               Files rendered in parallel (default: half the CPU cores)
+        --block <n>              Processing block size, also the automation resolution (default 512);
+                                 blocks are also cut at every automation breakpoint
+        --automation <file.json> Parameter values and breakpoints, e.g.
+                                     { "gain": [[0.0, 1.0], [10.0, 6.0]], "oversampling": "4x" }
+                                 Arrays are [seconds, value] pairs, linearly interpolated.
+                                 Parameters that change the latency (oversampling, oversamplingFilter,
+                                 limiter, limiterLookahead) only take a single value.
+        --<parameterID> <value>  Constant value for any parameter, e.g. --gain 4 --eqBoost 3
+                                 (choices can be given by index or by name, e.g. --oversampling 4x;
+                                 toggles as 0/1 or on/off, e.g. --limiter on)
+
+    Each file goes through a three-stage pipeline (decode -> process -> encode),
+    with each stage on its own thread, handing fixed-size chunks along bounded
+    queues. Inputs are read through memory-mapped readers where the format supports it.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+//==============================================================================
+namespace
+{
+    const char* const outputSuffix = "_satgain";
+    constexpr int chunkSize = 16384; // Frames handed between pipeline stages
+    constexpr int numChunks = 4;     // Chunks in flight per file
+
+    //==============================================================================
+    bool findParameter(const juce::String& paramID, Parameters::ID& result)
+    {
+        for (auto& spec : Parameters::specs)
+        {
+            if (paramID == spec.paramID)
+            {
+                result = spec.id;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Numbers as they are; choice names ("4x", "FIR") map to their index, toggles also take on/off
+    bool parseValue(Parameters::ID id, const juce::var& value, float& result)
+    {
+        const auto& spec = Parameters::getSpec(id);
+
+        if (value.isString() && spec.isToggle)
+        {
+            for (auto [name, state] : { std::pair<const char*, float>{ "on", 1.0f }, { "off", 0.0f }, { "true", 1.0f }, { "false", 0.0f } })
+            {
+                if (value.toString().equalsIgnoreCase(name))
+                {
+                    result = state;
+                    return true;
+                }
+            }
+        }
+
+        if (value.isString() && spec.isChoice())
+        {
+            for (int i = 0; i < spec.numChoices; ++i)
+            {
+                if (value.toString().equalsIgnoreCase(spec.choices[i]))
+                {
+                    result = (float)i;
+                    return true;
+                }
+            }
+        }
+
+        if (value.isString() && ! value.toString().containsOnly("0123456789.-+eE"))
+            return false;
+
+        result = juce::jlimit(spec.minimum, spec.maximum, (float)(double)value);
+        return true;
+    }
+
+    //==============================================================================
+    // Parameter values for a render: constants and breakpoint lanes, evaluated per block.
+    // The renderer cuts blocks at the breakpoints, as a host with sample-accurate automation would.
+    class Automation
+    {
+    public:
+        void setConstant(Parameters::ID id, float value)
+        {
+            auto& lane = lanes[(size_t)id];
+            lane.points = { { 0.0, value } };
+        }
+
+        bool loadJson(const juce::File& file, juce::String& error)
+        {
+            auto json = juce::JSON::parse(file);
+            auto* object = json.getDynamicObject();
+
+            if (object == nullptr)
+            {
+                error = "couldn't parse " + file.getFullPathName() + " as a JSON object";
+                return false;
+            }
+
+            for (auto& property : object->getProperties())
+            {
+                Parameters::ID id;
+                if (! findParameter(property.name.toString(), id))
+                {
+                    error = "unknown parameter \"" + property.name.toString() + "\" in " + file.getFileName();
+                    return false;
+                }
+
+                auto& lane = lanes[(size_t)id];
+                lane.points.clear();
+
+                if (auto* points = property.value.getArray())
+                {
+                    for (auto& point : *points)
+                    {
+                        float value = 0.0f;
+                        if (point.size() != 2 || ! parseValue(id, point[1], value))
+                        {
+                            error = "\"" + property.name.toString() + "\" needs [seconds, value] pairs";
+                            return false;
+                        }
+
+                        lane.points.push_back({ (double)point[0], value });
+                    }
+
+                    std::sort(lane.points.begin(), lane.points.end());
+                }
+                else
+                {
+                    float value = 0.0f;
+                    if (! parseValue(id, property.value, value))
+                    {
+                        error = "bad value for \"" + property.name.toString() + "\"";
+                        return false;
+                    }
+
+                    lane.points.push_back({ 0.0, value });
+                }
+            }
+
+            // The latency is read once and trimmed from the front of the output, so anything that
+            // changes it part-way through would shift the audio after that point
+            for (auto id : { Parameters::ID::oversampling, Parameters::ID::oversamplingFilter,
+                             Parameters::ID::limiter, Parameters::ID::limiterLookahead })
+            {
+                const auto& points = lanes[(size_t)id].points;
+
+                for (auto& point : points)
+                {
+                    if (point.second != points.front().second)
+                    {
+                        error = "\"" + juce::String(Parameters::getParamID(id)) + "\" changes the latency, so it can't be automated;"
+                                " give it a single value";
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        void apply(GainKnobAudioProcessor& processor, double timeSeconds) const
+        {
+            for (auto& spec : Parameters::specs)
+            {
+                const auto& points = lanes[(size_t)spec.id].points;
+                if (points.empty())
+                    continue;
+
+                float value = points.back().second;
+
+                for (size_t i = 0; i < points.size(); ++i)
+                {
+                    if (timeSeconds < points[i].first)
+                    {
+                        if (i == 0)
+                        {
+                            value = points[0].second;
+                        }
+                        else
+                        {
+                            const auto& a = points[i - 1];
+                            const auto& b = points[i];
+                            const double proportion = (timeSeconds - a.first) / juce::jmax(1.0e-9, b.first - a.first);
+                            value = spec.isStepped() ? a.second : (float)(a.second + proportion * (b.second - a.second)); // Choices and toggles step
+                        }
+
+                        break;
+                    }
+                }
+
+                auto* param = processor.parameters.getParameter(spec.paramID);
+                const float normalised = param->convertTo0to1(value);
+
+                if (param->getValue() != normalised)
+                    param->setValueNotifyingHost(normalised);
+            }
+        }
+
+        // Time of the first breakpoint after timeSeconds on any automated lane, or infinity
+        double getNextBreakpoint(double timeSeconds) const
+        {
+            double next = std::numeric_limits<double>::infinity();
+
+            for (auto& lane : lanes)
+            {
+                if (lane.points.size() < 2)
+                    continue; // A constant, nothing ever changes
+
+                for (auto& point : lane.points)
+                {
+                    if (point.first > timeSeconds)
+                    {
+                        next = juce::jmin(next, point.first);
+                        break;
+                    }
+                }
+            }
+
+            return next;
+        }
+
+    private:
+        struct Lane
+        {
+            std::vector<std::pair<double, float>> points; // (seconds, value), sorted by time
+        };
+
+        std::array<Lane, Parameters::numParameters> lanes;
+    };
+
+    //==============================================================================
+    struct Chunk
+    {
+        juce::AudioBuffer<float> buffer;
+        int numFrames = 0;
+        bool isLast = false;
+    };
+
+    // Blocking hand-off between two pipeline stages
+    class ChunkQueue
+    {
+    public:
+        void push(Chunk* chunk)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                chunks.push_back(chunk);
+            }
+
+            condition.notify_one();
+        }
+
+        Chunk* pop()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return ! chunks.empty(); });
+
+            auto* chunk = chunks.front();
+            chunks.pop_front();
+            return chunk;
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<Chunk*> chunks;
+    };
+
+    //==============================================================================
+    struct RenderOptions
+    {
+        juce::File outputDirectory;
+        int blockSize = 512;
+        Automation automation;
+    };
+
+    struct RenderResult
+    {
+        bool ok = false;
+        juce::String message;
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+    };
+
+    std::unique_ptr<juce::AudioFormatReader> openReader(juce::AudioFormatManager& formats, const juce::File& file)
+    {
+        if (auto* format = formats.findFormatForFileExtension(file.getFileExtension()))
+        {
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+
+            if (mapped != nullptr && mapped->mapEntireFile())
+                return mapped;
+        }
+
+        return std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(file)); // Format without mmap support
+    }
+
+    RenderResult renderFile(juce::AudioFormatManager& formats, const juce::File& input, const RenderOptions& options)
+    {
+        RenderResult result;
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        auto reader = openReader(formats, input);
+        if (reader == nullptr)
+        {
+            result.message = "can't read " + input.getFullPathName();
+            return result;
+        }
+
+        const int numChannels = (int)reader->numChannels;
+        const double sampleRate = reader->sampleRate;
+        const juce::int64 length = reader->lengthInSamples;
+
+        GainKnobAudioProcessor processor;
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, options.blockSize);
+        options.automation.apply(processor, 0.0);
+        processor.prepareToPlay(sampleRate, options.blockSize);
+
+        // Oversampling latency: feed that many extra zeros in, drop that many samples from the front
+        const int latency = processor.getLatencySamples();
+        const juce::int64 framesToProcess = length + latency;
+
+        auto outputFile = (options.outputDirectory == juce::File() ? input.getParentDirectory() : options.outputDirectory)
+                              .getChildFile(input.getFileNameWithoutExtension() + outputSuffix + input.getFileExtension());
+        outputFile.deleteFile();
+
+        auto* format = formats.findFormatForFileExtension(input.getFileExtension());
+        auto stream = std::make_unique<juce::FileOutputStream>(outputFile);
+        const int bitDepth = format->getPossibleBitDepths().contains((int)reader->bitsPerSample) ? (int)reader->bitsPerSample : 24;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        if (stream->openedOk())
+            writer.reset(format->createWriterFor(stream.get(), sampleRate, (unsigned int)numChannels, bitDepth, {}, 0));
+
+        if (writer == nullptr)
+        {
+            result.message = "can't write " + outputFile.getFullPathName();
+            return result;
+        }
+
+        stream.release(); // The writer owns it now
+
+        std::array<Chunk, numChunks> chunks;
+        ChunkQueue freeChunks, decodedChunks, processedChunks;
+
+        for (auto& chunk : chunks)
+        {
+            chunk.buffer.setSize(numChannels, chunkSize);
+            freeChunks.push(&chunk);
+        }
+
+        // Stage 1: decode
+        std::thread decoder([&]
+            {
+                for (juce::int64 position = 0;;)
+                {
+                    auto* chunk = freeChunks.pop();
+                    chunk->numFrames = (int)juce::jmin((juce::int64)chunkSize, framesToProcess - position);
+                    chunk->buffer.clear();
+
+                    const auto framesFromFile = (int)juce::jlimit((juce::int64)0, (juce::int64)chunk->numFrames, length - position);
+                    if (framesFromFile > 0)
+                        reader->read(&chunk->buffer, 0, framesFromFile, position, true, true);
+
+                    position += chunk->numFrames;
+                    chunk->isLast = position >= framesToProcess;
+                    decodedChunks.push(chunk);
+
+                    if (chunk->isLast)
+                        break;
+                }
+            });
+
+        // Stage 3: encode, dropping the latency from the front
+        std::thread encoder([&]
+            {
+                juce::int64 position = 0;
+
+                for (bool done = false; ! done;)
+                {
+                    auto* chunk = processedChunks.pop();
+                    done = chunk->isLast;
+
+                    const int skip = (int)juce::jlimit((juce::int64)0, (juce::int64)chunk->numFrames, latency - position);
+                    const int count = (int)juce::jmin((juce::int64)(chunk->numFrames - skip), length - juce::jmax((juce::int64)0, position - latency));
+
+                    if (count > 0)
+                        writer->writeFromAudioSampleBuffer(chunk->buffer, skip, count);
+
+                    position += chunk->numFrames;
+                    freeChunks.push(chunk);
+                }
+            });
+
+        // Stage 2: process, on this thread, block by block so the automation is applied at the block rate.
+        // A block that would run over an automation breakpoint is cut there, so a step or a change of
+        // slope starts on its own sample; the processor's gain ramp takes it from there.
+        juce::MidiBuffer midi;
+        juce::int64 position = 0;
+
+        for (bool done = false; ! done;)
+        {
+            auto* chunk = decodedChunks.pop();
+            done = chunk->isLast;
+
+            for (int start = 0; start < chunk->numFrames;)
+            {
+                const auto frame = position + start - latency;
+                const double timeSeconds = (double)frame / sampleRate;
+                int numFrames = juce::jmin(options.blockSize, chunk->numFrames - start);
+
+                const double breakpoint = options.automation.getNextBreakpoint(timeSeconds);
+
+                if (breakpoint < std::numeric_limits<double>::infinity())
+                    numFrames = (int)juce::jlimit((juce::int64)1, (juce::int64)numFrames, (juce::int64)std::ceil(breakpoint * sampleRate) - frame);
+
+                juce::AudioBuffer<float> block(chunk->buffer.getArrayOfWritePointers(), numChannels, start, numFrames);
+
+                options.automation.apply(processor, timeSeconds);
+                processor.processBlock(block, midi);
+                start += numFrames;
+            }
+
+            position += chunk->numFrames;
+            processedChunks.push(chunk);
+        }
+
+        decoder.join();
+        encoder.join();
+        writer.reset();
+        processor.releaseResources();
+
+        result.ok = true;
+        result.audioSeconds = (double)length / sampleRate;
+        result.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        result.message = outputFile.getFullPathName();
+        return result;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser; // The parameter tree needs the message manager to exist
+
+    RenderOptions options;
+    juce::Array<juce::File> inputs;
+    int numJobs = juce::jmax(1, juce::SystemStats::getNumCpus() / 2);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        Parameters::ID id;
+
+        if (arg == "--out" && hasValue)
+        {
+            options.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+            options.outputDirectory.createDirectory();
+        }
+        else if (arg == "--jobs" && hasValue)
+        {
+            numJobs = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        }
+        else if (arg == "--block" && hasValue)
+        {
+            options.blockSize = juce::jlimit(16, 8192, juce::String(argv[++i]).getIntValue());
+        }
+        else if (arg == "--automation" && hasValue)
+        {
+            juce::String error;
+            if (! options.automation.loadJson(juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]), error))
+            {
+                std::cerr << "Error: " << error << std::endl;
+                return 1;
+            }
+        }
+        else if (arg.startsWith("--") && hasValue && findParameter(arg.substring(2), id))
+        {
+            float value = 0.0f;
+            if (! parseValue(id, juce::String(argv[++i]), value))
+            {
+                std::cerr << "Error: bad value for " << arg << std::endl;
+                return 1;
+            }
+
+            options.automation.setConstant(id, value);
+        }
+        else if (arg.startsWith("--"))
+        {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            return 1;
+        }
+        else
+        {
+            inputs.add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+        }
+    }
+
+    if (inputs.isEmpty())
+    {
+        std::cerr << "Usage: SatGainRender [--out dir] [--jobs n] [--block n] [--automation file.json] [--<parameterID> value]... files..." << std::endl;
+        return 1;
+    }
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    juce::CriticalSection outputLock;
+    std::atomic<int> numFailed{ 0 };
+    double totalAudioSeconds = 0.0;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    {
+        juce::ThreadPool pool(numJobs);
+
+        for (auto& input : inputs)
+        {
+            pool.addJob([&, input]
+                {
+                    auto result = renderFile(formats, input, options);
+
+                    const juce::ScopedLock sl(outputLock);
+
+                    if (result.ok)
+                    {
+                        totalAudioSeconds += result.audioSeconds;
+                        std::cout << juce::String::formatted("%8.2f s audio %8.2f s wall %9.1fx real-time  ",
+                                                             result.audioSeconds, result.wallSeconds,
+                                                             result.audioSeconds / juce::jmax(1.0e-9, result.wallSeconds))
+                                  << result.message << std::endl;
+                    }
+                    else
+                    {
+                        ++numFailed;
+                        std::cerr << "Error: " << result.message << std::endl;
+                    }
+                });
+        }
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(20);
+    }
+
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    std::cout << juce::String::formatted("Total: %d files, %.2f s of audio in %.2f s (%.1fx real-time, %d jobs)",
+                                         inputs.size() - numFailed.load(), totalAudioSeconds, wallSeconds,
+                                         totalAudioSeconds / juce::jmax(1.0e-9, wallSeconds), numJobs) << std::endl;
+
+    return numFailed > 0 ? 1 : 0;
+}